@@ -24,8 +24,11 @@
 #define INTERFACE_APP_H_
 
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <functional>
 #include <memory>
+#include <iostream>
 
 #include "mp/solver-app-base.h"
 #include "mp/backend-base.h"
@@ -39,8 +42,16 @@ namespace mp {
 /// and calls backend class
 class BackendApp {
 public:
-  BackendApp(std::unique_ptr<BasicBackend> pb)
-    : pb_(std::move(pb)) { InitHandlers(); }
+  /// Backend factory
+  using BackendFactory = std::function< std::unique_ptr<BasicBackend>() >;
+
+  /// Construct.
+  /// @param be_creator: factory for a new backend, needed
+  ///   in the persistent mode when a model cannot be updated in place
+  BackendApp(std::unique_ptr<BasicBackend> pb,
+             BackendFactory be_creator = {})
+    : pb_(std::move(pb)), be_creator_(std::move(be_creator))
+  { InitHandlers(); }
 
   /// Runs the application.
   /// It processes command-line arguments and, if the file name (stub) is
@@ -63,13 +74,30 @@ protected:
   virtual bool Init(char** argv);
   virtual void InitHandlers();
 
+  /// Set NL filename and basename from the stub
+  void SetStub(const char* stub);
+
+  /// Persistent mode: run on further NL stubs read from stdin
+  virtual void RunPersistent();
+
+  /// Run the current stub by a new backend,
+  /// initialized with the original command-line arguments
+  virtual bool RestartBackend();
+
 
 private:
   std::unique_ptr<BasicBackend> pb_;
+  BackendFactory be_creator_;
   int result_code_ = 0;
 
   std::string nl_filename_, filename_no_ext_;
 
+  /// Command-line arguments and position of the stub there
+  std::vector<char*> args_;
+  std::size_t stub_pos_ = 0;
+  /// Current stub in the persistent mode
+  std::string stub_;
+
   std::unique_ptr<internal::SignalHandler> p_sig_handler_;
   std::unique_ptr<internal::SolverAppOptionParser> p_option_parser_;
 
@@ -81,16 +109,53 @@ int BackendApp::Run(char **argv) {
     return result_code_;
   GetBackend().RunFromNLFile(
         nl_filename_, filename_no_ext_);
-  return 0;
+  if (GetBackend().IsPersistent())
+    RunPersistent();
+  return result_code_;
+}
+
+void BackendApp::RunPersistent() {
+  while (GetBackend().IsPersistent() &&
+         std::getline(std::cin, stub_) && !stub_.empty()) {
+    SetStub(stub_.c_str());
+    GetBackend().SetBasename(filename_no_ext_);
+    if (!GetBackend().ResolveFromNLFile(nl_filename_, filename_no_ext_) &&
+        !RestartBackend())
+      break;
+  }
+}
+
+bool BackendApp::RestartBackend() {
+  if (!be_creator_)
+    MP_RAISE("Persistent mode: the model has changed and "
+             "no backend factory is provided to convert it anew");
+  auto callbacks = GetBackend().GetCallbacks();
+  pb_ = be_creator_();
+  GetBackend().GetCallbacks() = callbacks;
+  InitHandlers();
+  auto args = args_;
+  args[stub_pos_] = &stub_[0];
+  if (!Init(args.data()))
+    return false;
+  GetBackend().RunFromNLFile(
+        nl_filename_, filename_no_ext_);
+  return true;
 }
 
 bool BackendApp::Init(char **argv) {
   /// Init solver/converter options
   GetBackend().Init(argv);
 
+  /// Save the arguments for RestartBackend()
+  char **argv_end = argv;
+  while (*argv_end)
+    ++argv_end;
+  args_.assign(argv, argv_end + 1);
+
   // Parse command-line arguments.
   const char *filename = p_option_parser_->Parse(argv);
   if (!filename) return false;
+  stub_pos_ = std::find(args_.begin(), args_.end(), filename) - args_.begin();
 
   if (GetBackend().ampl_flag()) {
     fmt::MemoryWriter banner;
@@ -101,14 +166,7 @@ bool BackendApp::Init(char **argv) {
     output_handler_.has_output = false;
   }
 
-  // Add .nl extension if necessary.
-  nl_filename_ = filename;
-  filename_no_ext_ = nl_filename_;
-  const char *ext = std::strrchr(filename, '.');
-  if (!ext || std::strcmp(ext, ".nl") != 0)
-    nl_filename_ += ".nl";
-  else
-    filename_no_ext_.resize(filename_no_ext_.size() - 3);
+  SetStub(filename);
   internal::SetBasename(GetBackend(), &filename_no_ext_);
 
   // Parse solver options.
@@ -124,6 +182,17 @@ bool BackendApp::Init(char **argv) {
   return true;
 }
 
+void BackendApp::SetStub(const char* filename) {
+  // Add .nl extension if necessary.
+  nl_filename_ = filename;
+  filename_no_ext_ = nl_filename_;
+  const char *ext = std::strrchr(filename, '.');
+  if (!ext || std::strcmp(ext, ".nl") != 0)
+    nl_filename_ += ".nl";
+  else
+    filename_no_ext_.resize(filename_no_ext_.size() - 3);
+}
+
 void BackendApp::InitHandlers() {
   p_sig_handler_ = std::unique_ptr<internal::SignalHandler>(
         new internal::SignalHandler(GetBackend()));
@@ -145,7 +214,7 @@ int RunBackendApp(char** argv,
                           std::unique_ptr<mp::BasicBackend>() > be_creator,
                         BasicBackend::Callbacks callbacks = {}) {
   try {
-    mp::BackendApp s(be_creator());
+    mp::BackendApp s(be_creator(), be_creator);
     s.GetBackend().GetCallbacks() = callbacks;
     return s.Run(argv);
   } catch (const mp::Error &e) {   // Why does MSVC 2019 or 2022 go to std::exception and not here?
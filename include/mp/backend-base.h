@@ -49,6 +49,18 @@ public:
   void RunFromNLFile(const std::string& nl_filename,
                      const std::string& filename_no_ext) = 0;
 
+  /// Runs Solver on a further NL file in the persistent mode,
+  /// updating the current model in place.
+  /// @return false if not possible:
+  ///   then the NL file should be run by a new backend
+  virtual
+  bool ResolveFromNLFile(const std::string& nl_filename,
+                         const std::string& filename_no_ext) = 0;
+
+  /// Whether to run on further NL files after the first one,
+  /// see BackendApp
+  virtual bool IsPersistent() const { return false; }
+
   /// Detailed steps for AMPLS C API
 
   /// Read NL.
@@ -185,22 +185,26 @@ public:
   void RunFromNLFile(const std::string& nl_filename,
                      const std::string& filename_no_ext) override {
     ReadNL(nl_filename, filename_no_ext);
-    InputExtras();
-
-    SetupTimerAndInterrupter();
-    if (exportFileMode() > 0)
-      DoWriteProblem(export_file_name());
-
-    // exportFileMode == 2 -> do not solve, just export
-    if (exportFileMode() != 2) 
-    {
-      Solve();
-      RecordSolveTime();
+    SolveAndReport();
+  }
 
-      Report();
-    }
+  /// Runs Solver on a further NL file in the persistent mode.
+  /// Only bounds, ranges and linear objective coefficients
+  /// can change, they are updated in the converted model
+  /// and in the solver model.
+  bool ResolveFromNLFile(const std::string& nl_filename,
+                         const std::string& filename_no_ext) override {
+    stats_.time = steady_clock::now();
+    if (!GetMM().UpdateNLModel(nl_filename, filename_no_ext))
+      return false;
+    SolveAndReport();
+    return true;
   }
 
+  /// Persistent mode
+  bool IsPersistent() const override
+  { return storedOptions_.persistent_; }
+
   /// Detailed steps for AMPLS C API
 
   /// Read NL
@@ -226,6 +230,24 @@ public:
 
 
 protected:
+  /// Process the model after reading or updating it
+  virtual void SolveAndReport() {
+    InputExtras();
+
+    SetupTimerAndInterrupter();
+    if (exportFileMode() > 0)
+      DoWriteProblem(export_file_name());
+
+    // exportFileMode == 2 -> do not solve, just export
+    if (exportFileMode() != 2) 
+    {
+      Solve();
+      RecordSolveTime();
+
+      Report();
+    }
+  }
+
   /// Solve, no model modification any more.
   /// Can report intermediate results via HandleFeasibleSolution() during this,
   /// otherwise in ReportResults()
@@ -234,6 +256,11 @@ protected:
   /// Report
   virtual void Report() {
     ReportResults();
+    if (auto* prs = GetRunStats()) {
+      prs->Set("phases", "setup", "time", stats_.setup_time);
+      prs->Set("phases", "solve", "time", stats_.solution_time);
+      WriteRunStats();
+    }
     if (verbose_mode())
       PrintWarnings();
     if ( timing() )
@@ -670,6 +697,8 @@ private:
     // For write prob
     std::string export_file_;
     std::string just_export_file_;
+
+    int persistent_=0;
   } storedOptions_;
 
   /// Once Impl allows FEASRELAX,
@@ -810,6 +839,16 @@ protected:
         storedOptions_.just_export_file_);
     }
 
+    AddStoredOption("tech:persistent persistent",
+      "0*/1: Whether to keep running after solving the model, "
+      "reading names of further NL stubs from standard input, "
+      "one per line, until an empty line or end of input. "
+      "If a further model differs from the previous one only in "
+      "variable bounds, constraint bounds and linear objective "
+      "coefficients, the converted model and, if the solver "
+      "supports this, the solver model are updated in place. "
+      "Otherwise the model is converted from scratch.",
+      storedOptions_.persistent_, 0, 1);
   }
 
   virtual void InitCustomOptions() { }
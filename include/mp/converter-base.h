@@ -1,6 +1,8 @@
 #ifndef CONVERTERBASE_H
 #define CONVERTERBASE_H
 
+#include <string>
+
 #include "mp/env.h"
 #include "mp/ampls-ccallbacks.h"
 
@@ -29,9 +31,20 @@ public:
   /// Init solver options
   virtual void InitOptions() { }
 
+  /// Set the file the model has been read from,
+  /// e.g., for caching
+  virtual void SetInputFile(const std::string& ) { }
+
   /// Convert the model into the solver API
   virtual void ConvertModel() = 0;
 
+  /// Update the converted model in place, also in the solver API,
+  /// from \a new_model which should replace the current one.
+  /// May take over data from \a new_model.
+  /// @return false if not possible,
+  ///   then \a new_model needs a new conversion
+  virtual bool UpdateModel(ModelType& ) { return false; }
+
   /// Fill model traits
   virtual void FillModelTraits(AMPLS_ModelTraits& ) = 0;
 };
@@ -23,6 +23,7 @@
 #ifndef MP_EXPR_H_
 #define MP_EXPR_H_
 
+#include <cstdlib>
 #include <iterator>
 #include <memory>  // for std::allocator
 #include <vector>
@@ -661,6 +662,84 @@ struct ExprTypes {
 };
 }  /// namespace internal
 
+/// A bump allocator that releases all memory at once on destruction.
+/// Expression factories using it don't keep track of individual
+/// expressions which makes construction of large expression trees
+/// cheaper and keeps nodes adjacent in memory.
+class ArenaAllocator {
+ private:
+  struct Block {
+    Block *next;
+    std::size_t size;
+  };
+
+  char *ptr_;
+  char *end_;
+  Block *blocks_;
+  std::size_t next_block_size_;
+  std::size_t allocated_;
+
+  enum {
+    ALIGNMENT = sizeof(double) > sizeof(void*) ? sizeof(double) :
+                                                 sizeof(void*),
+    MIN_BLOCK_SIZE = 1 << 16,
+    MAX_BLOCK_SIZE = 1 << 24
+  };
+
+  static std::size_t Align(std::size_t size) {
+    return (size + ALIGNMENT - 1) & ~static_cast<std::size_t>(ALIGNMENT - 1);
+  }
+
+  // Allocates a new block with at least size bytes available.
+  char *AllocateBlock(std::size_t size);
+
+  void Init() {
+    ptr_ = end_ = 0;
+    blocks_ = 0;
+    next_block_size_ = MIN_BLOCK_SIZE;
+    allocated_ = 0;
+  }
+
+  // Assignment of arenas is not supported.
+  ArenaAllocator &operator=(const ArenaAllocator &);
+
+ public:
+  typedef char value_type;
+
+  ArenaAllocator() { Init(); }
+
+  /// Constructs an empty arena, memory is never shared between copies.
+  ArenaAllocator(const ArenaAllocator &) { Init(); }
+
+  ~ArenaAllocator();
+
+  /// Allocates size bytes aligned for any fundamental type.
+  char *allocate(std::size_t size) {
+    size = Align(size);
+    if (size > static_cast<std::size_t>(end_ - ptr_))
+      return AllocateBlock(size);
+    char *result = ptr_;
+    ptr_ += size;
+    return result;
+  }
+
+  /// Does nothing: memory is released when the arena is destroyed.
+  void deallocate(char *, std::size_t) {}
+
+  /// Returns the number of bytes allocated from the system.
+  std::size_t allocated() const { return allocated_; }
+};
+
+namespace internal {
+/// Checks if Alloc owns the memory of all objects allocated with it
+/// so that they don't need to be released one by one.
+template <typename Alloc>
+struct OwnsAllocations { enum { value = 0 }; };
+
+template <>
+struct OwnsAllocations<ArenaAllocator> { enum { value = 1 }; };
+}  // namespace internal
+
 /// An expression factory.
 /// Alloc: a memory allocator.
 /// Allocator requirements:
@@ -681,13 +760,21 @@ class BasicExprFactory : private Alloc {
   /// extra_bytes: extra bytes to allocate at the end (can be negative).
   template <typename ExprType>
   typename ExprType::Impl *Allocate(expr::Kind kind, int extra_bytes = 0) {
+    typedef typename ExprType::Impl Impl;
+    Impl *impl = 0;
+    if (internal::OwnsAllocations<Alloc>::value) {
+      /// The arena releases expressions, no need to track them.
+      impl = reinterpret_cast<Impl*>(
+            this->allocate(sizeof(Impl) + extra_bytes));
+      impl->kind_ = kind;
+      return impl;
+    }
     /// Call push_back first to make sure that the impl pointer doesn't leak
     /// if push_back throws an exception.
     exprs_.push_back(0);
-    typedef typename ExprType::Impl Impl;
     /// The following cannot overflow.
     /// Using malloc due to #174
-    Impl *impl = (Impl*)std::malloc(sizeof(Impl) + extra_bytes);
+    impl = (Impl*)std::malloc(sizeof(Impl) + extra_bytes);
     impl->kind_ = kind;
     exprs_.back() = impl;
     return impl;
@@ -788,6 +875,8 @@ class BasicExprFactory : private Alloc {
   explicit BasicExprFactory(Alloc alloc = Alloc()) : Alloc(alloc) {}
 
   virtual ~BasicExprFactory() {
+    if (internal::OwnsAllocations<Alloc>::value)
+      return;
     Deallocate(exprs_);
     Deallocate(funcs_);
   }
@@ -28,12 +28,14 @@ class FlatBackend :
     public BackendWithValuePresolver {
 public:
   /// Default GetSolution() for flat backends.
-  /// Invokes postsolver.
+  /// Invokes postsolver and the solution check.
   Solution GetSolution() override {
+    auto x = PrimalSolution();
     auto mv = GetValuePresolver().PostsolveSolution(
-          { PrimalSolution(),
+          { x,
             DualSolution(),
             GetObjectiveValues() } );
+    GetValuePresolver().CheckPresolvedSolution(x);
     return{ mv.GetVarValues()(),
           mv.GetConValues()(),
           mv.GetObjValues()() };
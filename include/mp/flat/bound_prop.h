@@ -0,0 +1,777 @@
+/**
+ * Whole-model bound propagation (feasibility-based bound tightening)
+ * over the flat model.
+ *
+ * Run before the constraint conversions, so that
+ * the big-M values and PL domains chosen there
+ * use the tightened variable bounds.
+ * The index can be kept for probing during the conversions.
+ */
+
+#ifndef MP_FLAT_BOUND_PROP_H
+#define MP_FLAT_BOUND_PROP_H
+
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unordered_map>
+
+#include "mp/utils-hash-stream.h"
+#include "mp/flat/constr_std.h"
+#include "mp/flat/constr_hash.h"
+#include "mp/flat/redef/conic/cones.h"
+
+
+namespace mp {
+
+/**
+ * Functor propagating variable bounds through the active
+ * linear, quadratic, and functional (linear, quadratic,
+ * max, min, abs) constraints until a fixpoint.
+ * Conditional linear constraints and the logical
+ * and, or, not, implication propagate
+ * between their binary results and arguments.
+ *
+ * A constraint-variable incidence index is built once.
+ * Every constraint is processed initially; afterwards,
+ * only the constraints of variables whose bounds changed.
+ * Quadratic terms are used as intervals to tighten
+ * the linear part; their variables are not tightened.
+ *
+ * If the index is kept, ProbeBounds() can run the propagation
+ * with a variable fixed, e.g., an indicator's binary variable
+ * fixed to its inactive value, to bound an expression;
+ * the bounds are restored afterwards.
+ *
+ * @param MCType the main converter.
+ */
+template <class MCType>
+class BoundPropagator : public MCKeeper<MCType> {
+public:
+  /// Constructor
+  BoundPropagator(MCType& mc) : MCKeeper<MCType>(mc) { }
+
+  /// Run the propagation.
+  /// Stops at a detected infeasibility, leaving it
+  /// for the solver to report.
+  /// @param round_int: round bounds of integer variables
+  /// @param keep_index: keep the constraint index
+  ///   for ProbeBounds() until Clear()
+  void Run(bool round_int, bool keep_index) {
+    Clear();
+    round_int_ = round_int;
+    n_tightened_ = n_processed_ = 0;
+    n_probes_ = n_probe_cache_hits_ = 0;
+    infeas_msg_.clear();
+    Collect();
+    BuildIncidence();
+    Propagate();
+    if (!keep_index || infeasible())
+      Clear();
+  }
+
+  /// Bound linear expression \a body by propagation
+  /// with variable \a var fixed to \a val.
+  /// Uses the constraints indexed by the last Run().
+  /// Results are cached by (var, val, body).
+  /// @return false if not applicable or infeasible
+  bool ProbeBounds(int var, double val, const LinTerms& body,
+                   double& lo, double& hi) {
+    if (var+1 >= (int)inc_start_.size() ||
+        inc_start_[var]==inc_start_[var+1] ||
+        val < MC().lb(var) || val > MC().ub(var))
+      return false;
+    ProbeKey key;
+    key.var_ = var;
+    key.val_ = val;
+    key.body_ = body;
+    auto it = probe_cache_.find(key);
+    if (probe_cache_.end() != it) {
+      ++n_probe_cache_hits_;
+      lo = it->second.first;
+      hi = it->second.second;
+      return lo <= hi;
+    }
+    ++n_probes_;
+    probing_ = true;
+    queue_.clear();
+    in_queue_.assign(items_.size(), 0);
+    cur_item_ = -1;
+    SaveBounds(var);
+    MC().set_var_lb(var, val);
+    MC().set_var_ub(var, val);
+    OnBoundChanged(var);
+    ProcessQueue(kProbeSteps);
+    if (infeasible()) {
+      lo = INFINITY;                  // cache as not applicable
+      hi = -INFINITY;
+    } else
+      BodyBounds(body, lo, hi);
+    for (auto i=trail_.size(); i--; ) {      // restore the bounds
+      MC().set_var_lb(trail_[i].var_, trail_[i].lb_);
+      MC().set_var_ub(trail_[i].var_, trail_[i].ub_);
+    }
+    trail_.clear();
+    infeas_msg_.clear();
+    probing_ = false;
+    probe_cache_.emplace(std::move(key), std::make_pair(lo, hi));
+    return lo <= hi;
+  }
+
+  /// Free the constraint index and the probing cache
+  void Clear() {
+    items_.clear(); items_.shrink_to_fit();
+    lin_coefs_.clear(); lin_coefs_.shrink_to_fit();
+    lin_vars_.clear(); lin_vars_.shrink_to_fit();
+    quad_coefs_.clear(); quad_coefs_.shrink_to_fit();
+    quad_vars1_.clear(); quad_vars1_.shrink_to_fit();
+    quad_vars2_.clear(); quad_vars2_.shrink_to_fit();
+    func_vars_.clear(); func_vars_.shrink_to_fit();
+    inc_start_.clear(); inc_start_.shrink_to_fit();
+    inc_items_.clear(); inc_items_.shrink_to_fit();
+    queue_.clear(); queue_.shrink_to_fit();
+    in_queue_.clear(); in_queue_.shrink_to_fit();
+    probe_cache_.clear();
+    row_lin_end_ = row_quad_end_ = 0;
+  }
+
+  /// Number of tightened bounds in the last run
+  int num_tightened() const { return n_tightened_; }
+
+  /// Number of processed constraints in the last run
+  int num_processed() const { return n_processed_; }
+
+  /// Number of probes since the last Run()
+  int num_probes() const { return n_probes_; }
+
+  /// Number of probe cache hits since the last Run()
+  int num_probe_cache_hits() const { return n_probe_cache_hits_; }
+
+  /// Whether the last run detected infeasibility
+  bool infeasible() const { return !infeas_msg_.empty(); }
+
+  /// Infeasibility description
+  const std::string& infeasibility_message() const
+  { return infeas_msg_; }
+
+
+protected:
+  enum ItemKind { ROW, COND, FUNC_MAX, FUNC_MIN, FUNC_ABS, FUNC_IMPL };
+
+  /// A constraint: algebraic row lb_ <= body <= ub_
+  /// with linear terms [beg_, end_) and quadratic terms
+  /// [qbeg_, qend_); a conditional row
+  /// res_ = (lb_ <= body <= ub_), strict_ for < or >;
+  /// or a functional constraint
+  /// with result and arguments [beg_, end_) in func_vars_
+  struct Item {
+    int kind_ = ROW;
+    int beg_ = 0, end_ = 0;
+    int qbeg_ = 0, qend_ = 0;
+    double lb_ = -INFINITY, ub_ = INFINITY;
+    int res_ = -1;
+    bool strict_ = false;
+  };
+
+  /// Collect the active constraints
+  void Collect() {
+    WalkAlg<LinConRange>();
+    WalkAlg<LinConLE>();
+    WalkAlg<LinConEQ>();
+    WalkAlg<LinConGE>();
+    WalkAlg<QuadConRange>();
+    WalkAlg<QuadConLE>();
+    WalkAlg<QuadConEQ>();
+    WalkAlg<QuadConGE>();
+    MC().GetConstraintKeeper((LinearFunctionalConstraint*)nullptr).
+        ForEachActive([this](const LinearFunctionalConstraint& con, int ) {
+      const auto& ae = con.GetAffineExpr();
+      AddLinTerms(ae.GetLinTerms());
+      lin_coefs_.push_back(-1.0);
+      lin_vars_.push_back(con.GetResultVar());
+      FinishRow(-ae.constant_term(), -ae.constant_term());
+      return false;
+    });
+    MC().GetConstraintKeeper((QuadraticFunctionalConstraint*)nullptr).
+        ForEachActive([this](const QuadraticFunctionalConstraint& con, int ) {
+      const auto& qe = con.GetQuadExpr();
+      AddLinTerms(qe.GetLinTerms());
+      lin_coefs_.push_back(-1.0);
+      lin_vars_.push_back(con.GetResultVar());
+      AddQuadTerms(qe.GetQPTerms());
+      FinishRow(-qe.constant_term(), -qe.constant_term());
+      return false;
+    });
+    WalkFunc<MaxConstraint>(FUNC_MAX);
+    WalkFunc<MinConstraint>(FUNC_MIN);
+    WalkFunc<AbsConstraint>(FUNC_ABS);
+    WalkCond<CondLinConLT>(true);
+    WalkCond<CondLinConLE>(false);
+    WalkCond<CondLinConEQ>(false);
+    WalkCond<CondLinConGE>(false);
+    WalkCond<CondLinConGT>(true);
+    WalkFunc<OrConstraint>(FUNC_MAX);          // over binary variables
+    WalkFunc<AndConstraint>(FUNC_MIN);
+    WalkFunc<ImplicationConstraint>(FUNC_IMPL);
+    MC().GetConstraintKeeper((NotConstraint*)nullptr).
+        ForEachActive([this](const NotConstraint& con, int ) {
+      lin_coefs_.push_back(1.0);               // r + x == 1
+      lin_vars_.push_back(con.GetResultVar());
+      lin_coefs_.push_back(1.0);
+      lin_vars_.push_back(con.GetArguments()[0]);
+      FinishRow(1.0, 1.0);
+      return false;
+    });
+  }
+
+  /// Collect conditional linear constraints \a Con
+  template <class Con>
+  void WalkCond(bool strict) {
+    MC().GetConstraintKeeper((Con*)nullptr).ForEachActive(
+          [this, strict](const Con& cc, int ) {
+      const auto& con = cc.GetConstraint();
+      AddLinTerms(con.GetBody());
+      FinishRow(con.lb(), con.ub());
+      items_.back().kind_ = COND;
+      items_.back().res_ = cc.GetResultVar();
+      items_.back().strict_ = strict;
+      return false;
+    });
+  }
+
+  /// Collect algebraic constraints of type \a Con
+  template <class Con>
+  void WalkAlg() {
+    MC().GetConstraintKeeper((Con*)nullptr).ForEachActive(
+          [this](const Con& con, int ) {
+      AddBody(con.GetBody());
+      FinishRow(con.lb(), con.ub());
+      return false;
+    });
+  }
+
+  /// Collect functional constraints \a Con: r = func(args)
+  template <class Con>
+  void WalkFunc(int kind) {
+    MC().GetConstraintKeeper((Con*)nullptr).ForEachActive(
+          [this, kind](const Con& con, int ) {
+      Item item;
+      item.kind_ = kind;
+      item.beg_ = (int)func_vars_.size();
+      func_vars_.push_back(con.GetResultVar());
+      for (auto v: con.GetArguments())
+        func_vars_.push_back(v);
+      item.end_ = (int)func_vars_.size();
+      items_.push_back(item);
+      return false;
+    });
+  }
+
+  void AddBody(const LinTerms& lt) { AddLinTerms(lt); }
+
+  void AddBody(const QuadAndLinTerms& qlt) {
+    AddLinTerms(qlt.GetLinTerms());
+    AddQuadTerms(qlt.GetQPTerms());
+  }
+
+  void AddLinTerms(const LinTerms& lt) {
+    for (size_t i=0; i<lt.size(); ++i) {
+      lin_coefs_.push_back(lt.coef(i));
+      lin_vars_.push_back(lt.var(i));
+    }
+  }
+
+  void AddQuadTerms(const QuadTerms& qt) {
+    for (int i=0; i<(int)qt.size(); ++i) {
+      quad_coefs_.push_back(qt.coef(i));
+      quad_vars1_.push_back(qt.var1(i));
+      quad_vars2_.push_back(qt.var2(i));
+    }
+  }
+
+  /// Finish an algebraic row started at the previous row's end
+  void FinishRow(double lb, double ub) {
+    Item item;
+    item.kind_ = ROW;
+    item.beg_ = row_lin_end_;
+    item.end_ = row_lin_end_ = (int)lin_vars_.size();
+    item.qbeg_ = row_quad_end_;
+    item.qend_ = row_quad_end_ = (int)quad_vars1_.size();
+    item.lb_ = lb;
+    item.ub_ = ub;
+    items_.push_back(item);
+  }
+
+  /// Build the variable -> constraints index
+  void BuildIncidence() {
+    inc_start_.assign(MC().num_vars()+1, 0);
+    ForEachItemVar([this](int , int v) { ++inc_start_[v+1]; });
+    for (size_t v=1; v<inc_start_.size(); ++v)
+      inc_start_[v] += inc_start_[v-1];
+    inc_items_.resize(inc_start_.back());
+    auto fill = inc_start_;
+    ForEachItemVar([this, &fill](int i, int v) {
+      inc_items_[fill[v]++] = i;
+    });
+  }
+
+  /// Call fn(item, var) for every variable occurrence
+  template <class Fn>
+  void ForEachItemVar(Fn fn) {
+    for (int i=0; i<(int)items_.size(); ++i) {
+      const auto& item = items_[i];
+      if (ROW==item.kind_ || COND==item.kind_) {
+        for (int k=item.beg_; k<item.end_; ++k)
+          fn(i, lin_vars_[k]);
+        for (int k=item.qbeg_; k<item.qend_; ++k) {
+          fn(i, quad_vars1_[k]);
+          fn(i, quad_vars2_[k]);
+        }
+        if (item.res_ >= 0)
+          fn(i, item.res_);
+      } else
+        for (int k=item.beg_; k<item.end_; ++k)
+          fn(i, func_vars_[k]);
+    }
+  }
+
+  /// Process all constraints, then the changed ones
+  void Propagate() {
+    in_queue_.assign(items_.size(), 1);
+    queue_.resize(items_.size());
+    for (int i=0; i<(int)items_.size(); ++i)
+      queue_[i] = i;
+    ProcessQueue(20 * items_.size() + 1000);
+  }
+
+  /// Process the change-driven queue.
+  /// The number of steps is limited in case
+  /// bounds converge slowly.
+  void ProcessQueue(size_t max_steps) {
+    size_t head = 0;
+    for (size_t step=0;
+         head < queue_.size() && step < max_steps && !infeasible();
+         ++step) {
+      cur_item_ = queue_[head++];
+      if (head >= 4096 && 2*head >= queue_.size()) {     // compact
+        queue_.erase(queue_.begin(), queue_.begin()+head);
+        head = 0;
+      }
+      in_queue_[cur_item_] = 0;
+      ++n_processed_;
+      const auto& item = items_[cur_item_];
+      switch (item.kind_) {
+      case ROW: PropagateRow(item, item.lb_, item.ub_); break;
+      case COND: PropagateCond(item); break;
+      case FUNC_MAX: PropagateMax(item); break;
+      case FUNC_MIN: PropagateMin(item); break;
+      case FUNC_ABS: PropagateAbs(item); break;
+      case FUNC_IMPL: PropagateImpl(item); break;
+      }
+    }
+  }
+
+  /// Activity bounds: finite sum + number of infinite terms
+  struct Activity {
+    double fin_ = 0.0;
+    int n_inf_ = 0;
+    void Add(double c) {
+      if (IsInf(c))
+        ++n_inf_;
+      else
+        fin_ += c;
+    }
+    /// Activity without the term \a c.
+    /// @return false if unbounded
+    bool Residual(double c, double& res) const {
+      if (IsInf(c)) {
+        if (1!=n_inf_)
+          return false;
+        res = fin_;
+      } else {
+        if (n_inf_)
+          return false;
+        res = fin_ - c;
+      }
+      return true;
+    }
+  };
+
+  /// Propagate a linear / quadratic row lb <= body <= ub
+  void PropagateRow(const Item& row, double lb, double ub) {
+    Activity amin, amax;
+    ComputeActivity(row, amin, amax);
+    if (!CheckRowFeasibility(lb, ub, amin, amax))
+      return;
+    for (int k=row.beg_; k<row.end_; ++k) {
+      auto a = lin_coefs_[k];
+      auto v = lin_vars_[k];
+      if (std::fabs(a) < 1e-9)
+        continue;
+      double res;
+      if (!IsInf(ub) && amin.Residual(cmin_[k-row.beg_], res)) {
+        auto b = (ub - res) / a;
+        if (a > 0.0)
+          TightenUB(v, b);
+        else
+          TightenLB(v, b);
+      }
+      if (!IsInf(lb) && amax.Residual(cmax_[k-row.beg_], res)) {
+        auto b = (lb - res) / a;
+        if (a > 0.0)
+          TightenLB(v, b);
+        else
+          TightenUB(v, b);
+      }
+    }
+  }
+
+  /// Activity bounds of a row's body.
+  /// Linear terms' contributions go to cmin_, cmax_
+  void ComputeActivity(const Item& row, Activity& amin, Activity& amax) {
+    cmin_.clear();
+    cmax_.clear();
+    for (int k=row.beg_; k<row.end_; ++k) {
+      auto a = lin_coefs_[k];
+      auto v = lin_vars_[k];
+      auto lo = Mul(a, MC().lb(v)), hi = Mul(a, MC().ub(v));
+      if (a < 0.0)
+        std::swap(lo, hi);
+      cmin_.push_back(lo);
+      cmax_.push_back(hi);
+      amin.Add(lo);
+      amax.Add(hi);
+    }
+    for (int k=row.qbeg_; k<row.qend_; ++k) {
+      auto lohi = QuadTermBounds(k);
+      amin.Add(lohi.first);
+      amax.Add(lohi.second);
+    }
+  }
+
+  /// r = (lb_ <= body <= ub_).
+  /// r==1: propagate the row, strict comparisons relaxed;
+  /// r==0: propagate the complement of an inequality;
+  /// otherwise fix r if the activity decides the row
+  void PropagateCond(const Item& c) {
+    auto r = c.res_;
+    if (MC().lb(r) >= 1.0)
+      PropagateRow(c, c.lb_, c.ub_);
+    else if (MC().ub(r) <= 0.0) {
+      if (IsInf(c.lb_))
+        PropagateRow(c, c.ub_, INFINITY);
+      else if (IsInf(c.ub_))
+        PropagateRow(c, -INFINITY, c.lb_);
+    } else {
+      Activity amin, amax;
+      ComputeActivity(c, amin, amax);
+      auto lo = amin.n_inf_ ? -INFINITY : amin.fin_;
+      auto hi = amax.n_inf_ ? INFINITY : amax.fin_;
+      auto margin_lb = c.strict_ && !IsInf(c.lb_) ? FeasTol(c.lb_) : 0.0;
+      auto margin_ub = c.strict_ && !IsInf(c.ub_) ? FeasTol(c.ub_) : 0.0;
+      if (lo >= c.lb_ + margin_lb && hi <= c.ub_ - margin_ub)
+        TightenLB(r, 1.0);
+      else if (lo > c.ub_ + FeasTol(c.ub_) || hi < c.lb_ - FeasTol(c.lb_))
+        TightenUB(r, 0.0);
+    }
+  }
+
+  /// Check that the row activity can meet bounds [lb, ub]
+  bool CheckRowFeasibility(double lb, double ub,
+                           const Activity& amin, const Activity& amax) {
+    if ((!amin.n_inf_ && amin.fin_ > ub + FeasTol(ub)) ||
+        (!amax.n_inf_ && amax.fin_ < lb - FeasTol(lb)))
+      return SetInfeasible("constraint activity bounds ["
+                + std::to_string(amin.n_inf_ ? -INFINITY : amin.fin_) + ", "
+                + std::to_string(amax.n_inf_ ? INFINITY : amax.fin_)
+                + "] outside its bounds ["
+                + std::to_string(lb) + ", "
+                + std::to_string(ub) + "]");
+    return true;
+  }
+
+  /// Bounds of the \a k-th quadratic term
+  std::pair<double, double> QuadTermBounds(int k) const {
+    auto x = quad_vars1_[k], y = quad_vars2_[k];
+    auto lx=MC().lb(x), ux=MC().ub(x), ly=MC().lb(y), uy=MC().ub(y);
+    double lo, hi;
+    if (x!=y) {
+      double pb[4] = {Mul(lx, ly), Mul(lx, uy), Mul(ux, ly), Mul(ux, uy)};
+      lo = *std::min_element(pb, pb+4);
+      hi = *std::max_element(pb, pb+4);
+    } else {
+      lo = lx<=0.0 && ux>=0.0 ? 0.0 : std::min(lx*lx, ux*ux);
+      hi = std::max(lx*lx, ux*ux);
+    }
+    auto c = quad_coefs_[k];
+    if (c >= 0.0)
+      return { Mul(c, lo), Mul(c, hi) };
+    return { Mul(c, hi), Mul(c, lo) };
+  }
+
+  /// Bounds of a linear expression
+  void BodyBounds(const LinTerms& body, double& lo, double& hi) const {
+    lo = hi = 0.0;
+    for (size_t k=0; k<body.size(); ++k) {
+      auto a = body.coef(k);
+      auto l = Mul(a, MC().lb(body.var(k)));
+      auto u = Mul(a, MC().ub(body.var(k)));
+      if (a < 0.0)
+        std::swap(l, u);
+      lo += l;
+      hi += u;
+    }
+  }
+
+  /// r = max(args)
+  void PropagateMax(const Item& f) {
+    auto r = func_vars_[f.beg_];
+    double lo=-INFINITY, hi=-INFINITY;
+    for (int k=f.beg_+1; k<f.end_; ++k) {
+      lo = std::max(lo, MC().lb(func_vars_[k]));
+      hi = std::max(hi, MC().ub(func_vars_[k]));
+    }
+    TightenLB(r, lo);
+    TightenUB(r, hi);
+    int n_above = 0, k_above = -1;          // args which can reach lb(r)
+    for (int k=f.beg_+1; k<f.end_; ++k) {
+      TightenUB(func_vars_[k], MC().ub(r));
+      if (MC().ub(func_vars_[k]) >= MC().lb(r)) {
+        ++n_above;
+        k_above = k;
+      }
+    }
+    if (1==n_above)
+      TightenLB(func_vars_[k_above], MC().lb(r));
+  }
+
+  /// r = min(args)
+  void PropagateMin(const Item& f) {
+    auto r = func_vars_[f.beg_];
+    double lo=INFINITY, hi=INFINITY;
+    for (int k=f.beg_+1; k<f.end_; ++k) {
+      lo = std::min(lo, MC().lb(func_vars_[k]));
+      hi = std::min(hi, MC().ub(func_vars_[k]));
+    }
+    TightenLB(r, lo);
+    TightenUB(r, hi);
+    int n_below = 0, k_below = -1;          // args which can reach ub(r)
+    for (int k=f.beg_+1; k<f.end_; ++k) {
+      TightenLB(func_vars_[k], MC().lb(r));
+      if (MC().lb(func_vars_[k]) <= MC().ub(r)) {
+        ++n_below;
+        k_below = k;
+      }
+    }
+    if (1==n_below)
+      TightenUB(func_vars_[k_below], MC().ub(r));
+  }
+
+  /// r = abs(x)
+  void PropagateAbs(const Item& f) {
+    auto r = func_vars_[f.beg_];
+    auto x = func_vars_[f.beg_+1];
+    auto lx = MC().lb(x), ux = MC().ub(x);
+    TightenLB(r, lx>0.0 ? lx : (ux<0.0 ? -ux : 0.0));
+    TightenUB(r, std::max(-lx, ux));
+    TightenLB(x, -MC().ub(r));
+    TightenUB(x, MC().ub(r));
+  }
+
+  /// r = (a ? b : c) over binary variables
+  void PropagateImpl(const Item& f) {
+    auto r = func_vars_[f.beg_];
+    auto a = func_vars_[f.beg_+1];
+    auto b = func_vars_[f.beg_+2];
+    auto c = func_vars_[f.beg_+3];
+    if (Disjoint(r, b))
+      TightenUB(a, 0.0);
+    if (Disjoint(r, c))
+      TightenLB(a, 1.0);
+    if (MC().lb(a) >= 1.0)
+      Equate(r, b);
+    else if (MC().ub(a) <= 0.0)
+      Equate(r, c);
+    else {
+      TightenLB(r, std::min(MC().lb(b), MC().lb(c)));
+      TightenUB(r, std::max(MC().ub(b), MC().ub(c)));
+    }
+  }
+
+  /// Whether the domains of \a x and \a y are disjoint
+  bool Disjoint(int x, int y) const {
+    return MC().lb(x) > MC().ub(y) || MC().ub(x) < MC().lb(y);
+  }
+
+  /// Intersect the domains of \a x and \a y
+  void Equate(int x, int y) {
+    TightenLB(x, MC().lb(y));
+    TightenUB(x, MC().ub(y));
+    TightenLB(y, MC().lb(x));
+    TightenUB(y, MC().ub(x));
+  }
+
+  /// Tighten lb(v) to \a b if significantly better.
+  /// Enqueue the other constraints of \a v.
+  void TightenLB(int v, double b) {
+    if (!(b > -kInf))                       // also NaN
+      return;
+    if (round_int_ && MC().is_var_integer(v))
+      b = std::ceil(b - kIntTol);
+    auto lb0 = MC().lb(v), ub0 = MC().ub(v);
+    if (b <= lb0 + MinImprovement(lb0, v))
+      return;
+    if (b > ub0) {
+      if (b > ub0 + FeasTol(ub0)) {
+        SetInfeasible("empty domain of variable " + std::to_string(v));
+        return;
+      }
+      b = ub0;
+      if (b <= lb0)
+        return;
+    }
+    SaveBounds(v);
+    MC().set_var_lb(v, b);
+    OnBoundChanged(v);
+  }
+
+  /// Tighten ub(v) to \a b if significantly better.
+  void TightenUB(int v, double b) {
+    if (!(b < kInf))
+      return;
+    if (round_int_ && MC().is_var_integer(v))
+      b = std::floor(b + kIntTol);
+    auto lb0 = MC().lb(v), ub0 = MC().ub(v);
+    if (b >= ub0 - MinImprovement(ub0, v))
+      return;
+    if (b < lb0) {
+      if (b < lb0 - FeasTol(lb0)) {
+        SetInfeasible("empty domain of variable " + std::to_string(v));
+        return;
+      }
+      b = lb0;
+      if (b >= ub0)
+        return;
+    }
+    SaveBounds(v);
+    MC().set_var_ub(v, b);
+    OnBoundChanged(v);
+  }
+
+  /// Minimal improvement of a finite bound worth recording:
+  /// avoids long sequences of tiny steps
+  double MinImprovement(double b0, int v) const {
+    if (IsInf(b0) || (round_int_ && MC().is_var_integer(v)))
+      return 0.0;
+    return kMinImprovement * std::max(1.0, std::fabs(b0));
+  }
+
+  /// Save the bounds of \a v for restoring after a probe
+  void SaveBounds(int v) {
+    if (probing_) {
+      BoundsEntry be;
+      be.var_ = v;
+      be.lb_ = MC().lb(v);
+      be.ub_ = MC().ub(v);
+      trail_.push_back(be);
+    }
+  }
+
+  /// Enqueue constraints of \a v, except the current one
+  void OnBoundChanged(int v) {
+    if (!probing_)
+      ++n_tightened_;
+    for (int k=inc_start_[v]; k<inc_start_[v+1]; ++k) {
+      auto i = inc_items_[k];
+      if (i!=cur_item_ && !in_queue_[i]) {
+        in_queue_[i] = 1;
+        queue_.push_back(i);
+      }
+    }
+  }
+
+  /// Record infeasibility, stopping the propagation
+  bool SetInfeasible(std::string msg) {
+    if (infeas_msg_.empty())
+      infeas_msg_ = std::move(msg);
+    return false;
+  }
+
+  /// Product where 0*inf = 0
+  static double Mul(double a, double b)
+  { return (0.0==a || 0.0==b) ? 0.0 : a*b; }
+
+  /// Infinite (or practically so)
+  static bool IsInf(double a) { return std::fabs(a) >= kInf; }
+
+  /// Feasibility tolerance around \a b
+  static double FeasTol(double b)
+  { return kFeasTol * std::max(1.0, std::fabs(b)); }
+
+
+private:
+  static constexpr double kInf = 1e20;
+  static constexpr double kFeasTol = 1e-6;
+  static constexpr double kIntTol = 1e-6;
+  static constexpr double kMinImprovement = 1e-3;
+  static constexpr size_t kProbeSteps = 10000;
+
+  bool round_int_ = true;
+  int n_tightened_ = 0;
+  int n_processed_ = 0;
+  int cur_item_ = -1;
+  std::string infeas_msg_;
+  int n_probes_ = 0;
+  int n_probe_cache_hits_ = 0;
+
+  std::vector<Item> items_;
+  std::vector<double> lin_coefs_;
+  std::vector<int> lin_vars_;
+  std::vector<double> quad_coefs_;
+  std::vector<int> quad_vars1_, quad_vars2_;
+  std::vector<int> func_vars_;
+  int row_lin_end_ = 0, row_quad_end_ = 0;
+
+  std::vector<int> inc_start_, inc_items_;
+  std::vector<int> queue_;
+  std::vector<char> in_queue_;
+
+  std::vector<double> cmin_, cmax_;
+
+  /// Bounds saved during a probe
+  struct BoundsEntry {
+    int var_;
+    double lb_, ub_;
+  };
+  bool probing_ = false;
+  std::vector<BoundsEntry> trail_;
+
+  /// Probe cache key
+  struct ProbeKey {
+    int var_;
+    double val_;
+    LinTerms body_;
+    bool operator==(const ProbeKey& k) const
+    { return var_==k.var_ && val_==k.val_ && body_==k.body_; }
+  };
+  struct ProbeKeyHash {
+    size_t operator()(const ProbeKey& k) const {
+      HashStreamer hs;
+      hs.Add(k.var_);
+      hs.Add(k.val_);
+      hs.Add(std::hash<LinTerms>{}(k.body_));
+      return hs.FinalizeHashValue();
+    }
+  };
+  std::unordered_map<ProbeKey, std::pair<double, double>, ProbeKeyHash>
+    probe_cache_;
+
+  /// Retrieve the MC
+  using MCKeeper<MCType>::MC;
+};
+
+} // namespace mp
+
+#endif // MP_FLAT_BOUND_PROP_H
@@ -7,6 +7,10 @@
 
 #include <string>
 #include <cmath>
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include "mp/flat/constr_base.h"
 #include "mp/flat/expr_quadratic.h"
@@ -91,6 +95,8 @@ public:
   double lb() const { return lb_; }
   /// range ub()
   double ub() const { return ub_; }
+  /// set range
+  void set_range(double l, double u) { lb_=l; ub_=u; }
   /// negate
   void negate() { auto tmp=ub_; ub_=-lb_; lb_=-tmp; }
   /// operator==
@@ -157,6 +163,113 @@ using LinConGE = LinConRhs< 1>;
 /// Linear constraint c'x >  d
 using LinConGT = LinConRhs< 2>;
 
+/// Whether Con is a linear algebraic constraint
+template <class Con>
+struct IsLinearAlgebraicCon : std::false_type { };
+
+/// Linear algebraic constraints
+template <class RhsOrRange>
+struct IsLinearAlgebraicCon<
+    AlgebraicConstraint<LinTerms, RhsOrRange> > : std::true_type { };
+
+/// Whether Con is an algebraic constraint
+template <class Con>
+struct IsAlgebraicCon : std::false_type { };
+
+/// Algebraic constraints
+template <class Body, class RhsOrRange>
+struct IsAlgebraicCon<
+    AlgebraicConstraint<Body, RhsOrRange> > : std::true_type { };
+
+
+/// Compute activities (body values) of algebraic constraints
+/// at the point \a x.
+/// The rows are split between up to \a nthreads threads
+/// (0: hardware concurrency), at least \a min_nnz_per_thread
+/// nonzeros each.
+/// @return activities, one per constraint
+template <class Con>
+std::vector<double> ComputeActivities(
+    const std::vector<const Con*>& cons, ArrayRef<double> x,
+    int nthreads=1, std::size_t min_nnz_per_thread=100000) {
+  std::vector<double> act(cons.size());
+  auto compute = [&cons, &act, &x](std::size_t beg, std::size_t end) {
+    for (auto i=beg; i!=end; ++i)
+      act[i] = cons[i]->GetBody().ComputeValue(x);
+  };
+  std::size_t nnz = 0;
+  for (const auto* pc: cons)
+    nnz += pc->GetBody().size();
+  std::size_t num_threads = nthreads>0 ?
+        nthreads : std::thread::hardware_concurrency();
+  num_threads = std::min(num_threads, nnz / min_nnz_per_thread);
+  num_threads = std::min(num_threads, cons.size());
+  if (num_threads < 2) {
+    compute(0, cons.size());
+    return act;
+  }
+  std::vector<std::thread> threads;
+  for (std::size_t t=1; t<num_threads; ++t)
+    threads.push_back(std::thread(compute,
+                                  cons.size() * t / num_threads,
+                                  cons.size() * (t+1) / num_threads));
+  compute(0, cons.size() / num_threads);
+  for (auto& thr: threads)
+    thr.join();
+  return act;
+}
+
+
+////////////////////////////////////////////////////////////////////////
+/// A block of linear constraints lb <= c'x <= ub
+/// in compressed sparse row format.
+/// Constraint keepers pass their linear constraints
+/// to a ModelAPI in such blocks if it AcceptsLinConBlocks()
+class LinConBlock {
+public:
+  /// Constructor
+  LinConBlock() : starts_(1, 0) { }
+
+  /// Reserve space for n constraints with nnz nonzeros
+  void reserve(std::size_t n, std::size_t nnz) {
+    lb_.reserve(n);
+    ub_.reserve(n);
+    starts_.reserve(n+1);
+    coefs_.reserve(nnz);
+    vars_.reserve(nnz);
+  }
+
+  /// Add a linear constraint
+  template <class RhsOrRange>
+  void add(const AlgebraicConstraint<LinTerms, RhsOrRange>& lc) {
+    lb_.push_back(lc.lb());
+    ub_.push_back(lc.ub());
+    coefs_.insert(coefs_.end(), lc.coefs().begin(), lc.coefs().end());
+    vars_.insert(vars_.end(), lc.vars().begin(), lc.vars().end());
+    starts_.push_back((int)vars_.size());
+  }
+
+  /// Number of constraints
+  int size() const { return (int)lb_.size(); }
+  /// Number of nonzeros
+  int num_nz() const { return (int)vars_.size(); }
+
+  /// Lower bounds, size() entries
+  const double* plb() const { return lb_.data(); }
+  /// Upper bounds, size() entries
+  const double* pub() const { return ub_.data(); }
+  /// Row starts, size()+1 entries
+  const int* pstarts() const { return starts_.data(); }
+  /// Variables, num_nz() entries
+  const int* pvars() const { return vars_.data(); }
+  /// Coefficients, num_nz() entries
+  const double* pcoefs() const { return coefs_.data(); }
+
+private:
+  std::vector<double> lb_, ub_, coefs_;
+  std::vector<int> starts_, vars_;
+};
+
 
 ////////////////////////////////////////////////////////////////////////
 /// Quadratic range constraint
@@ -1,16 +1,22 @@
 #ifndef CONSTRAINT_KEEPER_H
 #define CONSTRAINT_KEEPER_H
 
+#include <cstdint>
 #include <deque>
+#include <queue>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 #include <functional>
 #include <cmath>
 
 #include "mp/common.h"
 #include "mp/format.h"
 #include "mp/env.h"
+#include "mp/run-stats.h"
 #include "mp/flat/model_api_base.h"
 #include "mp/flat/constr_hash.h"
+#include "mp/flat/constr_serialize.h"
 #include "mp/flat/redef/redef_base.h"
 #include "mp/valcvt-node.h"
 
@@ -26,6 +32,52 @@ static const mp::OptionValueInfo values_item_acceptance[] = {
   { "2", "Accepted natively and preferred", 2}
 };
 
+/// Worklist of constraint keepers with pending (unconverted) items.
+/// Keepers are identified by slots and popped
+/// in the order of their conversion priority
+class ConstraintKeeperWorklist {
+public:
+  /// Register a keeper with given conversion priority
+  /// @return its slot
+  int Register(double priority) {
+    priority_.push_back(priority);
+    pending_.push_back(false);
+    return (int)priority_.size()-1;
+  }
+
+  /// Mark keeper slot as having pending items
+  void Push(int slot) {
+    assert(slot>=0 && slot<(int)pending_.size());
+    if (!pending_[slot]) {
+      pending_[slot] = true;
+      queue_.push( { priority_[slot], slot } );
+    }
+  }
+
+  /// Any pending keepers?
+  bool empty() const { return queue_.empty(); }
+
+  /// Pop the pending keeper with the smallest priority.
+  /// It stays marked pending until Done(slot)
+  int Pop() {
+    assert(!empty());
+    auto slot = queue_.top().second;
+    queue_.pop();
+    return slot;
+  }
+
+  /// Finished converting the popped keeper's items
+  void Done(int slot) { pending_[slot] = false; }
+
+private:
+  std::vector<double> priority_;
+  std::vector<bool> pending_;
+  std::priority_queue< std::pair<double, int>,
+    std::vector< std::pair<double, int> >,
+    std::greater< std::pair<double, int> > > queue_;
+};
+
+
 /// Interface for an array of constraints of certain type
 class BasicConstraintKeeper {
 public:
@@ -85,9 +137,31 @@ public:
   /// Report how many will be added to Backend
   virtual int GetNumberOfAddable() const = 0;
 
+  /// Number of constraints, incl. bridged
+  virtual int GetNumberOfItems() const = 0;
+
   /// This adds all unbridged items to the backend (without conversion)
   virtual void AddUnbridgedToBackend(BasicFlatModelAPI& be) = 0;
 
+  /// Violations of a solution for one constraint type
+  struct SolCheckResult {
+    /// Number of constraints checked
+    int n_checked_ = 0;
+    /// Number violated by more than the tolerance
+    int n_violated_ = 0;
+    /// Maximal violation
+    double max_viol_ = 0.0;
+    /// Index of the most violated constraint, -1 if none
+    int i_max_ = -1;
+  };
+
+  /// Check solution \a x against the unbridged constraints,
+  /// i.e., those passed to the solver.
+  /// Only algebraic constraints are checked currently.
+  /// @return false if this constraint type is not checked
+  virtual bool CheckSolution(ArrayRef<double> x, double feastol,
+                             int nthreads, SolCheckResult& res) const = 0;
+
   /// Value presolve node, const
   const pre::ValueNode& GetValueNode() const { return value_node_; }
 
@@ -171,16 +245,33 @@ public:
 	/// Mark as deleted, use index only
 	virtual void MarkAsDeleted(int i) = 0;
 
+  /// Serialize all constraints, incl. bridged
+  virtual void SerializeConstraints(BinaryWriter& wrt) const = 0;
+
+  /// Replace the constraints by deserialized ones.
+  /// They count as converted
+  virtual void DeserializeConstraints(BinaryReader& rd) = 0;
+
+  /// Attach to the conversion worklist
+  void SetWorklist(ConstraintKeeperWorklist& wl, int slot)
+  { worklist_ = &wl; worklist_slot_ = slot; }
+
 
 protected:
   int& GetAccLevRef() { return acceptance_level_; }
 
+  /// Schedule conversion of newly added items
+  void MarkPending()
+  { if (worklist_) worklist_->Push(worklist_slot_); }
+
 
 private:
   pre::ValueNode value_node_;
   const char* const constr_name_;
   const char* const solver_opt_nm_;
   int acceptance_level_ {-1};
+  ConstraintKeeperWorklist* worklist_ {nullptr};
+  int worklist_slot_ {-1};
 };
 
 
@@ -241,6 +332,7 @@ public:
   using BaseConverter::PropagateResult; \
   using BaseConverter::IfHasCvt_impl; \
   using BaseConverter::IfNeedsCvt_impl; \
+  using BaseConverter::PrepareCvt_impl; \
   using BaseConverter::Convert
 
 
@@ -309,6 +401,7 @@ public:
   int AddConstraint(Args&&... args)
   {
     cons_.emplace_back( std::move(args)... );
+    MarkPending();
     return cons_.size()-1;
   }
 
@@ -382,6 +475,9 @@ public:
     return (int)cons_.size()-n_bridged_;
   }
 
+  /// Number of constraints, incl. bridged
+  int GetNumberOfItems() const override { return (int)cons_.size(); }
+
   /// Group number of this constraint type in the Backend.
   /// This is needed for pre- / postsolve to group solution values
   int GetConstraintGroup(const BasicFlatModelAPI& ba) const override {
@@ -402,7 +498,51 @@ public:
   }
 
 
+  /// Check solution against the unbridged constraints
+  bool CheckSolution(ArrayRef<double> x, double feastol,
+                     int nthreads, SolCheckResult& res) const override {
+    return CheckSolution(x, feastol, nthreads, res,
+                         IsAlgebraicCon<Constraint>());
+  }
+
+
 protected:
+  /// CheckSolution(): not an algebraic constraint
+  bool CheckSolution(ArrayRef<double> , double ,
+                     int , SolCheckResult& , std::false_type) const {
+    return false;
+  }
+
+  /// CheckSolution(): compute activities of all rows
+  /// in one pass, then the bound violations
+  bool CheckSolution(ArrayRef<double> x, double feastol,
+                     int nthreads, SolCheckResult& res,
+                     std::true_type) const {
+    std::vector<const Constraint*> rows;
+    std::vector<int> indexes;
+    rows.reserve(GetNumberOfAddable());
+    indexes.reserve(GetNumberOfAddable());
+    for (int i=0; i<(int)cons_.size(); ++i) {
+      if (!cons_[i].IsBridged()) {
+        rows.push_back(&cons_[i].con_);
+        indexes.push_back(i);
+      }
+    }
+    auto act = ComputeActivities(rows, x, nthreads);
+    res = SolCheckResult();
+    res.n_checked_ = (int)rows.size();
+    for (size_t k=0; k<rows.size(); ++k) {
+      auto viol = std::max(rows[k]->lb() - act[k], act[k] - rows[k]->ub());
+      if (viol > feastol)
+        ++res.n_violated_;
+      if (viol > res.max_viol_) {
+        res.max_viol_ = viol;
+        res.i_max_ = indexes[k];
+      }
+    }
+    return true;
+  }
+
   /// Retrieve the Converter, const
   const Converter& GetConverter() const { return cvt_; }
   /// Retrieve the Converter
@@ -428,11 +568,13 @@ protected:
     const auto acceptanceLevel =
         GetChosenAcceptanceLevel();
     if (NotAccepted == acceptanceLevel) {
+      PrepareConversions(i+1);
       for ( ; ++i!=(int)cons_.size(); )
         if (!cons_[i].IsBridged())
           ConvertConstraint(cons_[i], i);
     }
     else if (AcceptedButNotRecommended == acceptanceLevel) {
+      PrepareConversions(i+1);
       for (; ++i != (int)cons_.size(); ) {
         if (!cons_[i].IsBridged()) {
           try {       // Try to convert all but allow failure
@@ -455,6 +597,17 @@ protected:
     return any_converted;
   }
 
+  /// Let the Converter prepare conversion of the
+  /// unbridged constraints from index \a i_first on
+  void PrepareConversions(int i_first) {
+    std::vector< std::pair<int, const Constraint*> > items;
+    for (int i=i_first; i<(int)cons_.size(); ++i)
+      if (!cons_[i].IsBridged())
+        items.push_back( { i, &cons_[i].con_ } );
+    if (items.size())
+      GetConverter().PrepareConversions(items);
+  }
+
 	/// Call Converter's RunConversion() and mark as "bridged".
   ///
 	/// @param cnt the constraint container -
@@ -479,6 +632,30 @@ public:
 		MarkAsDeleted(cons_.at(i), i);
 	}
 
+  /// Serialize all constraints, incl. bridged
+  void SerializeConstraints(BinaryWriter& wrt) const override {
+    SerializeSize(wrt, cons_.size());
+    for (const auto& cont: cons_) {
+      Serialize(wrt, cont.con_);
+      Serialize(wrt, cont.IsBridged());
+    }
+  }
+
+  /// Replace the constraints by deserialized ones
+  void DeserializeConstraints(BinaryReader& rd) override {
+    cons_.clear();
+    n_bridged_ = 0;
+    auto n = DeserializeSize(rd);
+    for (std::size_t i=0; i<n; ++i) {
+      cons_.emplace_back( Deserialize(rd, (Constraint*)nullptr) );
+      if (Deserialize(rd, (bool*)nullptr)) {
+        cons_.back().MarkAsBridged();
+        ++n_bridged_;
+      }
+    }
+    i_cvt_last_ = (int)cons_.size()-1;
+  }
+
 	/// ForEachActive().
 	/// Deletes every constraint where fn() returned true.
 	template <class Fn>
@@ -493,19 +670,57 @@ public:
 protected:
 	/// Add all non-converted items to ModelAPI
   void AddAllUnbridged(BasicFlatModelAPI& be) {
-    int con_index=0;
-    auto con_group = GetConstraintGroup(be);
-    for (const auto& cont: cons_) {
-      if (!cont.IsBridged()) {
+    AddAllUnbridged(be, std::integral_constant<bool,
+                    IsLinearAlgebraicCon<Constraint>::value &&
+                    Backend::AcceptsLinConBlocks()>());
+    AddCopyLinks(be);
+  }
+
+  /// Add unbridged items one by one
+  void AddAllUnbridged(BasicFlatModelAPI& be, std::false_type) {
+    for (const auto& cont: cons_)
+      if (!cont.IsBridged())
         static_cast<Backend&>(be).AddConstraint(cont.con_);
-        GetConverter().GetCopyLink().
-            AddEntry({
-                       GetValueNode().Select(con_index),
-                       GetConverter().GetValuePresolver().GetTargetNodes().
-                         GetConValues()(con_group).Add()
-                     });
+  }
+
+  /// Add unbridged linear constraints in a LinConBlock
+  void AddAllUnbridged(BasicFlatModelAPI& be, std::true_type) {
+    std::size_t n=0, nnz=0;
+    for (const auto& cont: cons_)
+      if (!cont.IsBridged()) {
+        ++n;
+        nnz += cont.con_.size();
       }
-      ++con_index;                      // increment index
+    if (!n)
+      return;
+    LinConBlock block;
+    block.reserve(n, nnz);
+    for (const auto& cont: cons_)
+      if (!cont.IsBridged())
+        block.add(cont.con_);
+    static_cast<Backend&>(be).AddLinearConstraints(block);
+  }
+
+  /// Link the unbridged items to their ModelAPI counterparts,
+  /// one CopyLink entry for each run of unbridged items
+  void AddCopyLinks(BasicFlatModelAPI& be) {
+    auto con_group = GetConstraintGroup(be);
+    const int n = (int)cons_.size();
+    for (int i=0; i<n; ) {
+      if (cons_[i].IsBridged()) {
+        ++i;
+        continue;
+      }
+      int i_end = i+1;
+      while (i_end<n && !cons_[i_end].IsBridged())
+        ++i_end;
+      GetConverter().GetCopyLink().
+          AddEntry({
+                     GetValueNode().Select(i, i_end-i),
+                     GetConverter().GetValuePresolver().GetTargetNodes().
+                       GetConValues()(con_group).Add(i_end-i)
+                   });
+      i = i_end;
     }
   }
 
@@ -593,7 +808,8 @@ public: \
 
 /// Create constraint map. Normally internal use
 #define STORE_CONSTRAINT_MAP(Constraint) \
-  ConstraintMap<Constraint> CONSTRAINT_MAP_VAR(Constraint); \
+  ConstraintMap<Constraint> CONSTRAINT_MAP_VAR(Constraint) \
+    {*static_cast<Impl*>(this), #Constraint}; \
   const ConstraintMap<Constraint>& \
   GetConstraintMap(Constraint* ) const { \
     return CONSTRAINT_MAP_VAR(Constraint); \
@@ -609,12 +825,163 @@ public: \
 
 
 /////////////////////////////////////////////////////////////////////////////
-/// Subexpression map
+/// Subexpression map without constraint type,
+/// provides lookup statistics
+class BasicConstraintMap {
+public:
+  /// Lookup statistics
+  struct Stats {
+    /// Number of Find() calls
+    std::size_t n_find_ = 0;
+    /// Number of successful Find() calls
+    std::size_t n_hit_ = 0;
+    /// Number of entries inspected by Find() and Insert()
+    std::size_t n_probe_ = 0;
+    /// Maximal number of entries inspected by a single call
+    std::size_t max_probe_ = 0;
+    /// Number of Find() and Insert() calls
+    std::size_t n_access_ = 0;
+  };
+
+  /// Constructor
+  BasicConstraintMap(const char* nm) : name_(nm) { }
+  /// Destructor
+  virtual ~BasicConstraintMap() { }
+
+  /// Constraint type name
+  const char* GetName() const { return name_; }
+  /// Number of entries
+  virtual std::size_t size() const = 0;
+  /// Lookup statistics
+  const Stats& GetStats() const { return stats_; }
+
+protected:
+  /// Count a lookup which inspected  n_probe entries
+  void CountProbes(std::size_t n_probe) const {
+    ++stats_.n_access_;
+    stats_.n_probe_ += n_probe;
+    if (stats_.max_probe_ < n_probe)
+      stats_.max_probe_ = n_probe;
+  }
+
+  /// Statistics are updated by const Find()
+  mutable Stats stats_;
+
+private:
+  const char* name_;
+};
+
+
+/// Subexpression map.
 ///
-/// Indexes constraint location
+/// Indexes constraint location.
+/// Open addressing with linear probing: each entry keeps
+/// the constraint's 64-bit structural hash, so that probing
+/// compares constraints only on hash match and growing
+/// the table does not rehash constraints.
+/// Constraints are referenced, not copied: the keepers
+/// store them in node-stable containers.
 template <class Constraint>
-using ConstraintMap = std::unordered_map<
-    std::reference_wrapper< const Constraint >, int >;
+class ConstraintMap : public BasicConstraintMap {
+public:
+  /// Constructor, adds this map to the provided ConstraintManager
+  template <class CM>
+  ConstraintMap(CM& cm, const char* nm) : BasicConstraintMap(nm)
+  { cm.AddConstraintMap(*this); }
+
+  /// Number of entries
+  std::size_t size() const override { return size_; }
+
+  /// Find constraint
+  /// @return its index, or -1
+  int Find(const Constraint& con) const {
+    ++stats_.n_find_;
+    if (!size_) {
+      CountProbes(0);
+      return -1;
+    }
+    const auto h = Hash(con);
+    const std::size_t mask = table_.size()-1;
+    std::size_t n_probe = 1;
+    for (std::size_t pos = h & mask; ; pos = (pos+1) & mask, ++n_probe) {
+      const auto& entry = table_[pos];
+      if (entry.index_ < 0)
+        break;
+      if (entry.hash_ == h &&
+          std::cref(*entry.pcon_) == std::cref(con)) {
+        ++stats_.n_hit_;
+        CountProbes(n_probe);
+        return entry.index_;
+      }
+    }
+    CountProbes(n_probe);
+    return -1;
+  }
+
+  /// Insert constraint with index  i.
+  /// @return false if an equal constraint is present already
+  bool Insert(const Constraint& con, int i) {
+    assert(i >= 0);
+    if (2 * (size_+1) > table_.size())
+      Grow();
+    const auto h = Hash(con);
+    const std::size_t mask = table_.size()-1;
+    std::size_t n_probe = 1;
+    std::size_t pos = h & mask;
+    for ( ; table_[pos].index_ >= 0; pos = (pos+1) & mask, ++n_probe) {
+      const auto& entry = table_[pos];
+      if (entry.hash_ == h &&
+          std::cref(*entry.pcon_) == std::cref(con)) {
+        CountProbes(n_probe);
+        return false;
+      }
+    }
+    CountProbes(n_probe);
+    table_[pos] = { h, &con, i };
+    ++size_;
+    return true;
+  }
+
+protected:
+  /// Structural hash, with the bits mixed
+  /// for power-of-2 table sizes
+  static std::uint64_t Hash(const Constraint& con) {
+    std::uint64_t h =
+        std::hash< std::reference_wrapper< const Constraint > >{}(
+          std::cref(con));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  /// Double the table, reusing the stored hashes
+  void Grow() {
+    std::vector<Entry> old;
+    old.swap(table_);
+    table_.resize(old.empty() ? 16 : 2*old.size(), { 0, nullptr, -1 });
+    const std::size_t mask = table_.size()-1;
+    for (const auto& entry: old) {
+      if (entry.index_ >= 0) {
+        std::size_t pos = entry.hash_ & mask;
+        while (table_[pos].index_ >= 0)
+          pos = (pos+1) & mask;
+        table_[pos] = entry;
+      }
+    }
+  }
+
+private:
+  struct Entry {
+    std::uint64_t hash_;
+    const Constraint* pcon_;
+    int index_;     // -1 for an empty slot
+  };
+  std::vector<Entry> table_ { };
+  std::size_t size_ = 0;
+};
 
 /// Subexpression maps for an expression require
 /// operator==(refwrap<expr>, refwrap<expr>).
@@ -663,12 +1030,44 @@ bool operator==(std::reference_wrapper<
 /// Manage ConstraintKeepers for different constraint types
 class ConstraintManager {
   std::multimap<double, BasicConstraintKeeper&> con_keepers_;
+  std::vector<const BasicConstraintMap*> con_maps_;
+  /// Keepers by worklist slot
+  std::vector<BasicConstraintKeeper*> worklist_keepers_;
+  ConstraintKeeperWorklist worklist_;
+  /// Number of ConvertAllNewWith() calls
+  std::size_t n_cvt_passes_ = 0;
 
 
 public:
   /// Add a new CKeeper with given conversion priority (smaller = sooner)
-  void AddConstraintKeeper(BasicConstraintKeeper& ck, double priority)
-  { con_keepers_.insert( { priority, ck } ); }
+  void AddConstraintKeeper(BasicConstraintKeeper& ck, double priority) {
+    con_keepers_.insert( { priority, ck } );
+    ck.SetWorklist(worklist_, worklist_.Register(priority));
+    worklist_keepers_.push_back(&ck);
+  }
+
+  /// Add a subexpression map
+  void AddConstraintMap(const BasicConstraintMap& cm)
+  { con_maps_.push_back(&cm); }
+
+  /// Print lookup statistics of the subexpression maps
+  void PrintConstraintMapStats(Env& env) const {
+    bool header = false;
+    for (const auto* pcm: con_maps_) {
+      const auto& st = pcm->GetStats();
+      if (!st.n_access_)
+        continue;
+      if (!header) {
+        env.Print("Subexpression maps:\n");
+        header = true;
+      }
+      env.Print("  {:<40} {:>9} entries, {:>9} lookups, {:5.1f}% hits, "
+                "{:.2f} avg / {} max probes\n",
+                pcm->GetName(), pcm->size(), st.n_find_,
+                st.n_find_ ? 100.0 * st.n_hit_ / st.n_find_ : 0.0,
+                double(st.n_probe_) / st.n_access_, st.max_probe_);
+    }
+  }
 
   /// This should be called after adding all constraint keepers
   void ConsiderAcceptanceOptions(
@@ -679,14 +1078,59 @@ public:
       ck.second.ConsiderAcceptanceOptions(cvt, ma, env);
   }
 
-  /// Convert all constraints (including any new appearing)
-  void ConvertAllConstraints(BasicFlatConverter& cvt) {
-    bool any_converted;
-    do {
-      any_converted = false;
-      for (auto& ck: con_keepers_)
-        any_converted = any_converted || ck.second.ConvertAllNewWith(cvt);
-    } while (any_converted);
+  /// Convert all constraints (including any new appearing).
+  /// Keepers with new items are drained in priority order
+  /// until none has pending items.
+  /// If \a prs is given, records the time of each keeper
+  void ConvertAllConstraints(BasicFlatConverter& cvt,
+                             RunStats* prs = nullptr) {
+    while (!worklist_.empty()) {
+      auto slot = worklist_.Pop();
+      ++n_cvt_passes_;
+      auto* pck = worklist_keepers_[slot];
+      {
+        ScopedRunTimer timer(prs, "keepers", pck->GetConstraintName());
+        pck->ConvertAllNewWith(cvt);
+      }
+      worklist_.Done(slot);
+    }
+  }
+
+  /// Record counters of the constraint keepers
+  /// and the subexpression maps
+  void AddRunStats(RunStats& rs) const {
+    for (const auto& ck: con_keepers_) {
+      auto n_items = ck.second.GetNumberOfItems();
+      if (!n_items)
+        continue;
+      auto n_addable = ck.second.GetNumberOfAddable();
+      const char* nm = ck.second.GetConstraintName();
+      rs.Set("keepers", nm, "items", n_items);
+      rs.Set("keepers", nm, "converted", n_items - n_addable);
+      rs.Set("keepers", nm, "added", n_addable);
+    }
+    for (const auto* pcm: con_maps_) {
+      const auto& st = pcm->GetStats();
+      if (!st.n_access_)
+        continue;
+      rs.Set("maps", pcm->GetName(), "entries", pcm->size());
+      rs.Set("maps", pcm->GetName(), "lookups", st.n_find_);
+      rs.Set("maps", pcm->GetName(), "hits", st.n_hit_);
+      rs.Set("maps", pcm->GetName(), "probes", st.n_probe_);
+      rs.Set("maps", pcm->GetName(), "max_probe", st.max_probe_);
+    }
+    rs.Set("phases", "ConvertAllConstraints", "passes", n_cvt_passes_);
+  }
+
+  /// Number of keeper conversion passes made
+  std::size_t NumConversionPasses() const { return n_cvt_passes_; }
+
+  /// Number of unbridged constraints of all types
+  int GetNumberOfAddable() const {
+    int n = 0;
+    for (const auto& ck: con_keepers_)
+      n += ck.second.GetNumberOfAddable();
+    return n;
   }
 
   /// Fill counters of unbridged constraints
@@ -701,6 +1145,67 @@ public:
     }
   }
 
+  /// Check solution \a x against the unbridged constraints
+  /// and print maximal violation per constraint type.
+  /// @return number of constraints violated by more than \a feastol
+  int CheckSolution(ArrayRef<double> x, double feastol,
+                    int nthreads, Env& env) const {
+    int n_violated = 0;
+    env.Print("Solution check (feastol {}):\n", feastol);
+    for (const auto& ck: con_keepers_) {
+      BasicConstraintKeeper::SolCheckResult res;
+      if (!ck.second.CheckSolution(x, feastol, nthreads, res) ||
+          !res.n_checked_)
+        continue;
+      n_violated += res.n_violated_;
+      env.Print("  {:<40} {:>9} checked, {:>9} violated, "
+                "max violation {:.3g}",
+                ck.second.GetConstraintName(), res.n_checked_,
+                res.n_violated_, res.max_viol_);
+      if (res.i_max_ >= 0)
+        env.Print(" (constraint {})", res.i_max_);
+      env.Print("\n");
+    }
+    return n_violated;
+  }
+
+  /// Add the chosen acceptance levels of all constraint types
+  /// to a hash
+  void HashAcceptanceLevels(HashStreamer& hs) const {
+    for (const auto& ck: con_keepers_)
+      hs.Add((int)ck.second.GetChosenAcceptanceLevel());
+  }
+
+  /// Serialize constraints of all types, by type name
+  void SerializeConstraints(BinaryWriter& wrt) const {
+    SerializeSize(wrt, con_keepers_.size());
+    for (const auto& ck: con_keepers_) {
+      BinaryWriter wrt_ck;
+      ck.second.SerializeConstraints(wrt_ck);
+      Serialize(wrt, std::string(ck.second.GetConstraintName()));
+      Serialize(wrt, wrt_ck.GetData());
+    }
+  }
+
+  /// Deserialize constraints written by SerializeConstraints()
+  void DeserializeConstraints(BinaryReader& rd) {
+    std::unordered_map<std::string, BasicConstraintKeeper*> keepers;
+    for (auto& ck: con_keepers_)
+      keepers[ck.second.GetConstraintName()] = &ck.second;
+    auto n = DeserializeSize(rd);
+    if (n != keepers.size())
+      MP_RAISE("Constraint data: constraint types do not match");
+    for (std::size_t i=0; i<n; ++i) {
+      auto name = Deserialize(rd, (std::string*)nullptr);
+      auto data = Deserialize(rd, (std::string*)nullptr);
+      auto it = keepers.find(name);
+      if (keepers.end() == it)
+        MP_RAISE("Constraint data: unknown constraint type " + name);
+      BinaryReader rd_ck(data);
+      it->second->DeserializeConstraints(rd_ck);
+    }
+  }
+
   /// Add all unbridged constraints to Backend
   void AddUnbridgedConstraintsToBackend(
       BasicFlatModelAPI& be) const {
@@ -0,0 +1,313 @@
+#ifndef CONSTRAINT_SERIALIZE_H
+#define CONSTRAINT_SERIALIZE_H
+
+/// Serialize()/Deserialize() for expressions, constraints
+/// and objectives of the flat model, see utils-serialize.h.
+/// Terms are restored in the stored order, without re-sorting.
+
+#include <string>
+
+#include "mp/utils-serialize.h"
+#include "mp/flat/constr_std.h"
+#include "mp/flat/obj_std.h"
+
+namespace mp {
+
+/// Serialize LinTerms
+inline void Serialize(BinaryWriter& wrt, const LinTerms& lt) {
+  Serialize(wrt, lt.coefs());
+  Serialize(wrt, lt.vars());
+}
+
+/// Deserialize LinTerms
+inline LinTerms Deserialize(BinaryReader& rd, LinTerms* ) {
+  auto coefs = Deserialize(rd, (std::vector<double>*)nullptr);
+  return { std::move(coefs), Deserialize(rd, (std::vector<int>*)nullptr) };
+}
+
+/// Serialize QuadTerms
+inline void Serialize(BinaryWriter& wrt, const QuadTerms& qt) {
+  Serialize(wrt, qt.coefs());
+  Serialize(wrt, qt.vars1());
+  Serialize(wrt, qt.vars2());
+}
+
+/// Deserialize QuadTerms
+inline QuadTerms Deserialize(BinaryReader& rd, QuadTerms* ) {
+  auto coefs = Deserialize(rd, (std::vector<double>*)nullptr);
+  auto vars1 = Deserialize(rd, (std::vector<int>*)nullptr);
+  return { std::move(coefs), std::move(vars1),
+        Deserialize(rd, (std::vector<int>*)nullptr) };
+}
+
+/// Serialize QuadAndLinTerms
+inline void Serialize(BinaryWriter& wrt, const QuadAndLinTerms& qlt) {
+  Serialize(wrt, qlt.GetLinTerms());
+  Serialize(wrt, qlt.GetQPTerms());
+}
+
+/// Deserialize QuadAndLinTerms.
+/// Not using the sorting constructor
+inline QuadAndLinTerms Deserialize(BinaryReader& rd, QuadAndLinTerms* ) {
+  QuadAndLinTerms qlt;
+  qlt.GetLinTerms() = Deserialize(rd, (LinTerms*)nullptr);
+  qlt.GetQPTerms() = Deserialize(rd, (QuadTerms*)nullptr);
+  return qlt;
+}
+
+/// Serialize AlgebraicExpression<>
+template <class Body>
+void Serialize(BinaryWriter& wrt, const AlgebraicExpression<Body>& ae) {
+  Serialize(wrt, ae.GetBody());
+  Serialize(wrt, ae.constant_term());
+}
+
+/// Deserialize AlgebraicExpression<>
+template <class Body>
+AlgebraicExpression<Body> Deserialize(
+    BinaryReader& rd, AlgebraicExpression<Body>* ) {
+  auto body = Deserialize(rd, (Body*)nullptr);
+  return { std::move(body), Deserialize(rd, (double*)nullptr) };
+}
+
+/// Serialize AlgConRange
+inline void Serialize(BinaryWriter& wrt, const AlgConRange& rng) {
+  Serialize(wrt, rng.lb());
+  Serialize(wrt, rng.ub());
+}
+
+/// Deserialize AlgConRange
+inline AlgConRange Deserialize(BinaryReader& rd, AlgConRange* ) {
+  auto lb = Deserialize(rd, (double*)nullptr);
+  return { lb, Deserialize(rd, (double*)nullptr) };
+}
+
+/// Serialize AlgConRhs<>
+template <int kind>
+void Serialize(BinaryWriter& wrt, const AlgConRhs<kind>& rhs)
+{ Serialize(wrt, rhs.rhs()); }
+
+/// Deserialize AlgConRhs<>
+template <int kind>
+AlgConRhs<kind> Deserialize(BinaryReader& rd, AlgConRhs<kind>* )
+{ return { Deserialize(rd, (double*)nullptr) }; }
+
+/// Serialize PLConParams, as PLPoints
+inline void Serialize(BinaryWriter& wrt, const PLConParams& prm) {
+  PLPoints plp = prm;
+  Serialize(wrt, plp.x_);
+  Serialize(wrt, plp.y_);
+}
+
+/// Deserialize PLConParams
+inline PLConParams Deserialize(BinaryReader& rd, PLConParams* ) {
+  auto x = Deserialize(rd, (std::vector<double>*)nullptr);
+  return PLPoints{ std::move(x), Deserialize(rd, (std::vector<double>*)nullptr) };
+}
+
+/// Serialize the result variable and context of a functional constraint
+inline void SerializeResult(BinaryWriter& wrt, const FunctionalConstraint& fc) {
+  Serialize(wrt, fc.GetResultVar());
+  Serialize(wrt, fc.GetContext().GetValue());
+}
+
+/// Deserialize the result variable and context of a functional constraint
+inline void DeserializeResult(BinaryReader& rd, FunctionalConstraint& fc) {
+  fc.SetResultVar(Deserialize(rd, (int*)nullptr));
+  fc.SetContext(Deserialize(rd, (Context::CtxVal*)nullptr));
+}
+
+/// Serialize AlgebraicConstraint<>
+template <class Body, class RhsOrRange>
+void Serialize(BinaryWriter& wrt,
+               const AlgebraicConstraint<Body, RhsOrRange>& con) {
+  Serialize(wrt, con.GetBody());
+  Serialize(wrt, con.GetRhsOrRange());
+  Serialize(wrt, std::string(con.GetName()));
+}
+
+/// Deserialize AlgebraicConstraint<>
+template <class Body, class RhsOrRange>
+AlgebraicConstraint<Body, RhsOrRange> Deserialize(
+    BinaryReader& rd, AlgebraicConstraint<Body, RhsOrRange>* ) {
+  auto body = Deserialize(rd, (Body*)nullptr);
+  AlgebraicConstraint<Body, RhsOrRange> con {
+    std::move(body), Deserialize(rd, (RhsOrRange*)nullptr), false };
+  con.SetName(Deserialize(rd, (std::string*)nullptr));
+  return con;
+}
+
+/// Serialize CustomFunctionalConstraint<>
+template <class Args, class Params, class NumOrLogic, class Id>
+void Serialize(BinaryWriter& wrt,
+               const CustomFunctionalConstraint<
+                 Args, Params, NumOrLogic, Id>& con) {
+  SerializeResult(wrt, con);
+  Serialize(wrt, con.GetArguments());
+  Serialize(wrt, con.GetParameters());
+  Serialize(wrt, std::string(con.GetName()));
+}
+
+/// Deserialize CustomFunctionalConstraint<>
+template <class Args, class Params, class NumOrLogic, class Id>
+CustomFunctionalConstraint<Args, Params, NumOrLogic, Id> Deserialize(
+    BinaryReader& rd,
+    CustomFunctionalConstraint<Args, Params, NumOrLogic, Id>* ) {
+  FunctionalConstraint fc;
+  DeserializeResult(rd, fc);
+  auto args = Deserialize(rd, (Args*)nullptr);
+  CustomFunctionalConstraint<Args, Params, NumOrLogic, Id> con {
+    std::move(args), Deserialize(rd, (Params*)nullptr) };
+  con.SetResultVar(fc.GetResultVar());
+  con.SetContext(fc.GetContext());
+  con.SetName(Deserialize(rd, (std::string*)nullptr));
+  return con;
+}
+
+/// Serialize ConditionalConstraint<>
+template <class Con>
+void Serialize(BinaryWriter& wrt, const ConditionalConstraint<Con>& con) {
+  SerializeResult(wrt, con);
+  Serialize(wrt, con.GetConstraint());
+  Serialize(wrt, std::string(con.GetName()));
+}
+
+/// Deserialize ConditionalConstraint<>
+template <class Con>
+ConditionalConstraint<Con> Deserialize(
+    BinaryReader& rd, ConditionalConstraint<Con>* ) {
+  FunctionalConstraint fc;
+  DeserializeResult(rd, fc);
+  ConditionalConstraint<Con> con {
+    fc.GetResultVar(), Deserialize(rd, (Con*)nullptr) };
+  con.SetContext(fc.GetContext());
+  con.SetName(Deserialize(rd, (std::string*)nullptr));
+  return con;
+}
+
+/// Serialize LinearFunctionalConstraint
+inline void Serialize(BinaryWriter& wrt,
+                      const LinearFunctionalConstraint& con) {
+  SerializeResult(wrt, con);
+  Serialize(wrt, con.GetAffineExpr());
+  Serialize(wrt, std::string(con.GetName()));
+}
+
+/// Deserialize LinearFunctionalConstraint
+inline LinearFunctionalConstraint Deserialize(
+    BinaryReader& rd, LinearFunctionalConstraint* ) {
+  FunctionalConstraint fc;
+  DeserializeResult(rd, fc);
+  LinearFunctionalConstraint con {
+    fc.GetResultVar(), Deserialize(rd, (AffineExpr*)nullptr) };
+  con.SetContext(fc.GetContext());
+  con.SetName(Deserialize(rd, (std::string*)nullptr));
+  return con;
+}
+
+/// Serialize QuadraticFunctionalConstraint
+inline void Serialize(BinaryWriter& wrt,
+                      const QuadraticFunctionalConstraint& con) {
+  SerializeResult(wrt, con);
+  Serialize(wrt, con.GetQuadExpr());
+  Serialize(wrt, std::string(con.GetName()));
+}
+
+/// Deserialize QuadraticFunctionalConstraint
+inline QuadraticFunctionalConstraint Deserialize(
+    BinaryReader& rd, QuadraticFunctionalConstraint* ) {
+  FunctionalConstraint fc;
+  DeserializeResult(rd, fc);
+  QuadraticFunctionalConstraint con {
+    fc.GetResultVar(), Deserialize(rd, (QuadraticExpr*)nullptr) };
+  con.SetContext(fc.GetContext());
+  con.SetName(Deserialize(rd, (std::string*)nullptr));
+  return con;
+}
+
+/// Serialize IndicatorConstraint<>
+template <class Con>
+void Serialize(BinaryWriter& wrt, const IndicatorConstraint<Con>& con) {
+  Serialize(wrt, con.get_binary_var());
+  Serialize(wrt, con.get_binary_value());
+  Serialize(wrt, con.get_constraint());
+  Serialize(wrt, std::string(con.GetName()));
+}
+
+/// Deserialize IndicatorConstraint<>
+template <class Con>
+IndicatorConstraint<Con> Deserialize(
+    BinaryReader& rd, IndicatorConstraint<Con>* ) {
+  auto b = Deserialize(rd, (int*)nullptr);
+  auto bv = Deserialize(rd, (int*)nullptr);
+  IndicatorConstraint<Con> con { b, bv, Deserialize(rd, (Con*)nullptr) };
+  con.SetName(Deserialize(rd, (std::string*)nullptr));
+  return con;
+}
+
+/// Serialize SOS_1or2_Constraint<>
+template <int type>
+void Serialize(BinaryWriter& wrt, const SOS_1or2_Constraint<type>& con) {
+  Serialize(wrt, con.get_vars());
+  Serialize(wrt, con.get_weights());
+  Serialize(wrt, con.get_sum_of_vars_range().lb_);
+  Serialize(wrt, con.get_sum_of_vars_range().ub_);
+  Serialize(wrt, std::string(con.GetName()));
+}
+
+/// Deserialize SOS_1or2_Constraint<>
+template <int type>
+SOS_1or2_Constraint<type> Deserialize(
+    BinaryReader& rd, SOS_1or2_Constraint<type>* ) {
+  auto vars = Deserialize(rd, (std::vector<int>*)nullptr);
+  auto weights = Deserialize(rd, (std::vector<double>*)nullptr);
+  auto lb = Deserialize(rd, (double*)nullptr);
+  SOS_1or2_Constraint<type> con { std::move(vars), std::move(weights),
+        SOSExtraInfo::Bounds{ lb, Deserialize(rd, (double*)nullptr) } };
+  con.SetName(Deserialize(rd, (std::string*)nullptr));
+  return con;
+}
+
+/// Serialize ComplementarityConstraint<>
+template <class Expr>
+void Serialize(BinaryWriter& wrt,
+               const ComplementarityConstraint<Expr>& con) {
+  Serialize(wrt, con.GetExpression());
+  Serialize(wrt, con.GetVariable());
+  Serialize(wrt, std::string(con.GetName()));
+}
+
+/// Deserialize ComplementarityConstraint<>
+template <class Expr>
+ComplementarityConstraint<Expr> Deserialize(
+    BinaryReader& rd, ComplementarityConstraint<Expr>* ) {
+  auto expr = Deserialize(rd, (Expr*)nullptr);
+  ComplementarityConstraint<Expr> con {
+    std::move(expr), Deserialize(rd, (int*)nullptr) };
+  con.SetName(Deserialize(rd, (std::string*)nullptr));
+  return con;
+}
+
+/// Serialize QuadraticObjective
+inline void Serialize(BinaryWriter& wrt, const QuadraticObjective& obj) {
+  Serialize(wrt, obj.obj_sense());
+  Serialize(wrt, obj.coefs());
+  Serialize(wrt, obj.vars());
+  Serialize(wrt, std::string(obj.name()));
+  Serialize(wrt, obj.GetQPTerms());
+}
+
+/// Deserialize QuadraticObjective
+inline QuadraticObjective Deserialize(
+    BinaryReader& rd, QuadraticObjective* ) {
+  auto sense = Deserialize(rd, (obj::Type*)nullptr);
+  auto coefs = Deserialize(rd, (std::vector<double>*)nullptr);
+  auto vars = Deserialize(rd, (std::vector<int>*)nullptr);
+  LinearObjective lo { sense, std::move(coefs), std::move(vars),
+        Deserialize(rd, (std::string*)nullptr) };
+  return { std::move(lo), Deserialize(rd, (QuadTerms*)nullptr) };
+}
+
+} // namespace mp
+
+#endif // CONSTRAINT_SERIALIZE_H
@@ -9,6 +9,7 @@
 #include <cassert>
 
 #include "mp/env.h"
+#include "mp/clock.h"
 #include "mp/format.h"
 #include "mp/solver-base.h"
 #include "mp/flat/converter_model.h"
@@ -18,11 +19,14 @@
 #include "mp/flat/expr_bounds.h"
 #include "mp/flat/constr_prepro.h"
 #include "mp/flat/constr_prop_down.h"
+#include "mp/flat/bound_prop.h"
 #include "mp/valcvt.h"
 #include "mp/flat/redef/std/range_con.h"
 #include "mp/flat/redef/conic/cones.h"
 #include "mp/flat/redef/conic/qcones2qc.h"
 #include "mp/utils-file.h"
+#include "mp/utils-serialize.h"
+#include "mp/utils-hash-stream.h"
 #include "mp/ampls-ccallbacks.h"
 
 namespace mp {
@@ -220,12 +224,28 @@ protected:
   ///
   //////////////////////////// THE CONVERSION LOOP: BREADTH-FIRST ///////////////////////
   void ConvertItems() {
+    auto* prs = GetEnv().GetRunStats();
     try {
-			MPD( Convert2Cones(); );                 // sweep before other conversions
-      MP_DISPATCH( ConvertAllConstraints() );
-      // MP_DISPATCH( PreprocessIntermediate() );     // preprocess after each level
-			MP_DISPATCH( ConvertMaps() );
-      MP_DISPATCH( PreprocessFinal() );               // final prepro
+      {
+        ScopedRunTimer timer(prs, "phases", "PreprocessIntermediate");
+        MP_DISPATCH( PreprocessIntermediate() );     // bounds for big-M's
+      }
+      {
+        ScopedRunTimer timer(prs, "phases", "Convert2Cones");
+        MPD( Convert2Cones(); );               // sweep before other conversions
+      }
+      {
+        ScopedRunTimer timer(prs, "phases", "ConvertAllConstraints");
+        MP_DISPATCH( ConvertAllConstraints() );
+      }
+      {
+        ScopedRunTimer timer(prs, "phases", "ConvertMaps");
+        MP_DISPATCH( ConvertMaps() );
+      }
+      {
+        ScopedRunTimer timer(prs, "phases", "PreprocessFinal");
+        MP_DISPATCH( PreprocessFinal() );             // final prepro
+      }
     } catch (const ConstraintConversionFailure& cff) {
       MP_RAISE(cff.message());
     }
@@ -245,7 +265,7 @@ protected:
 	}
 
   void ConvertAllConstraints() {
-    GetModel().ConvertAllConstraints(*this);
+    GetModel().ConvertAllConstraints(*this, GetEnv().GetRunStats());
   }
 
   /// Default map conversions. Currently empty
@@ -257,8 +277,33 @@ protected:
   }
 
   //////////////////////// WHOLE-MODEL PREPROCESSING /////////////////////////
-  void PreprocessIntermediate() { }
-  void PreprocessFinal() { }
+  /// Propagate variable bounds through the flat model
+  /// before the conversions
+  void PreprocessIntermediate() {
+    if (!IfPreproFBBT())
+      return;
+    bound_prop_.Run(!relax(), MPCD( IfProbeBigM() ));
+    if (bound_prop_.infeasible())
+      AddWarning("PreproFBBT", "Bound propagation detected infeasibility: "
+                 + bound_prop_.infeasibility_message());
+    if (auto* prs = GetEnv().GetRunStats()) {
+      prs->Set("presolve", "fbbt", "tightened", bound_prop_.num_tightened());
+      prs->Set("presolve", "fbbt", "processed", bound_prop_.num_processed());
+      prs->Set("presolve", "fbbt", "infeasible", bound_prop_.infeasible());
+    }
+  }
+  /// Free the bound propagation index kept for probing
+  void PreprocessFinal() {
+    if (auto* prs = GetEnv().GetRunStats())
+      if (bound_prop_.num_probes()) {
+        prs->Set("presolve", "bigM_probe", "probes",
+                 bound_prop_.num_probes());
+        prs->Set("presolve", "bigM_probe", "cache_hits",
+                 bound_prop_.num_probe_cache_hits());
+        prs->Set("presolve", "bigM_probe", "narrowed", n_probe_narrowed_);
+      }
+    bound_prop_.Clear();
+  }
 
 
   //////////////////////////// CONSTRAINT PROPAGATORS ///////////////////////////////////
@@ -345,6 +390,22 @@ public: // for ConstraintKeeper
     return false;
   }
 
+  /// Let the item converter prepare conversion of
+  /// a batch of new constraints, see
+  /// BasicItemConverter::PrepareConversions().
+  /// @param items: pairs (constraint index, constraint)
+  template <class Constraint>
+  void PrepareConversions(
+      const std::vector< std::pair<int, const Constraint*> >& items) {
+    MPD( PrepareCvt_impl(items) );
+  }
+
+  /// Generic batch preparation: nothing.
+  /// Specialized by INSTALL_ITEM_CONVERTER.
+  template <class Constraint>
+  void PrepareCvt_impl(
+      const std::vector< std::pair<int, const Constraint*> >& ) { }
+
   /// Check whether ModelAPI accepts and recommends the constraint
   template <class Constraint>
   static bool ModelAPIAcceptsAndRecommends(const Constraint* pcon) {
@@ -482,18 +543,205 @@ public:
     MPD( OpenGraphExporter() );
   }
 
-  /// Handle end of model input
+  /// Handle end of model input.
+  /// After a model cache hit (see ReadModelCache()),
+  /// only pushes the model to the ModelAPI
   void FinishModelInput() {
-    MPD( ConvertModel() );
-    if (relax())
-      GetModel().RelaxIntegrality();
-		FixUnusedDefinedVars();       // Until we have proper var deletion
-    GetModel().PushModelTo(GetModelAPI());
+    if (model_cache_hit_)
+      MPD( PrepareConversion() );
+    else {
+      MPD( ConvertModel() );
+      if (relax())
+        GetModel().RelaxIntegrality();
+      FixUnusedDefinedVars();     // Until we have proper var deletion
+      if (IfUseModelCache())
+        WriteModelCache();
+    }
+    {
+      ScopedRunTimer timer(GetEnv().GetRunStats(), "phases", "PushModelTo");
+      GetModel().PushModelTo(GetModelAPI());
+    }
     MPD( CloseGraphExporter() );
     if (value_presolver_.GetExport())
       assert( value_presolver_.AllEntriesExported() );
     if (GetEnv().verbose_mode())
       GetEnv().PrintWarnings();
+    if (GetEnv().timing()) {
+      GetEnv().Print("Constraint conversion passes: {}\n",
+                     GetModel().NumConversionPasses());
+      GetModel().PrintConstraintMapStats(GetEnv());
+      value_presolver_.PrintLinkStats(GetEnv());
+    }
+    if (auto* prs = GetEnv().GetRunStats()) {
+      prs->Set("model", "flat", "vars", num_vars());
+      prs->Set("model", "flat", "constraints",
+               GetModel().GetNumberOfAddable());
+      GetModel().AddRunStats(*prs);
+      value_presolver_.AddRunStats(*prs);
+    }
+  }
+
+  //////////////////////////// MODEL CACHE /////////////////////////////
+  /// Whether the model cache is switched on by option cvt:cache
+  bool IfModelCacheOn() const { return !options_.cacheDir_.empty(); }
+
+  /// Set the key of the input model for the model cache,
+  /// e.g., a hash of the NL file and the input options
+  void SetModelCacheKey(std::size_t key)
+  { input_cache_key_ = key; f_input_cache_key_ = true; }
+
+  /// Try and read the converted model from the cache.
+  /// To be called after StartModelInput(), instead of model input.
+  /// @return true iff the model has been read.
+  ///   Then FinishModelInput() skips the conversion
+  bool ReadModelCache() {
+    model_cache_hit_ = false;
+    if (!IfUseModelCache())
+      return false;
+    steady_clock::time_point start = steady_clock::now();
+    std::string data;
+    if (!ReadFileToString(GetModelCacheFileName(), data))
+      return false;
+    BinaryReader rd(data);
+    std::string payload;
+    try {
+      if (Deserialize(rd, (std::string*)nullptr) != ModelCacheFormat() ||
+          Deserialize(rd, (std::size_t*)nullptr) != GetModelCacheKey())
+        return false;
+      payload = Deserialize(rd, (std::string*)nullptr);
+      if (Deserialize(rd, (std::size_t*)nullptr) !=
+          std::hash<std::string>()(payload) || !rd.AtEnd())
+        return false;
+    } catch (const std::exception& ) {  // truncated file
+      return false;
+    }
+    BinaryReader rd_pl(payload);        // Verified: errors are fatal now
+    GetModel().DeserializeModel(rd_pl);
+    value_presolver_.DeserializeGraph(rd_pl);
+    if (!rd_pl.AtEnd())
+      MP_RAISE("Model cache: extra data in " + GetModelCacheFileName());
+    model_cache_hit_ = true;
+    double read_time = GetTimeAndReset(start);
+    if (auto* prs = GetEnv().GetRunStats())
+      prs->AddTime("phases", "model cache read", read_time);
+    if (GetEnv().timing())
+      GetEnv().Print("Model cache read time = {:.6f}s\n", read_time);
+    return true;
+  }
+
+  /// Whether the model has been read from the cache
+  bool IfModelCacheHit() const { return model_cache_hit_; }
+
+  /// Add options of derived converters to the model cache key
+  void HashOptions(HashStreamer& ) const { }
+
+  /// Model cache file name
+  std::string GetModelCacheFileName() const {
+    return fmt::format("{}/flatmodel_{:016x}.bin",
+                       options_.cacheDir_, GetModelCacheKey());
+  }
+
+
+protected:
+  /// Whether to read and write the model cache
+  bool IfUseModelCache() const
+  { return IfModelCacheOn() && f_input_cache_key_; }
+
+  /// Write the converted model into the cache
+  void WriteModelCache() {
+    BinaryWriter wrt_pl;
+    GetModel().SerializeModel(wrt_pl);
+    if (!value_presolver_.SerializeGraph(wrt_pl)) {
+      AddWarning("ModelCache", "Model not cached: "
+                 "conversion graph node names not unique");
+      return;
+    }
+    BinaryWriter wrt;
+    Serialize(wrt, ModelCacheFormat());
+    Serialize(wrt, GetModelCacheKey());
+    Serialize(wrt, wrt_pl.GetData());
+    Serialize(wrt, std::hash<std::string>()(wrt_pl.GetData()));
+    if (!WriteStringToFile(GetModelCacheFileName(), wrt.GetData()))
+      AddWarning("ModelCache", "Failed to write model cache file "
+                 + GetModelCacheFileName());
+  }
+
+  /// Model cache format id. Change when the format changes
+  static std::string ModelCacheFormat() { return "mp-flat-model-cache-1"; }
+
+  /// Model cache key: the input key, the converter and ModelAPI
+  /// types, and options affecting the conversion
+  std::size_t GetModelCacheKey() const {
+    HashStreamer hs(input_cache_key_);
+    hs.Add(std::string(Impl::GetTypeName()));
+    hs.Add(std::string(ModelAPI::GetTypeName()));
+    hs.Add(options_.preprocessAnything_);
+    hs.Add(options_.preprocessEqualityResultBounds_);
+    hs.Add(options_.preprocessEqualityBvar_);
+    hs.Add(options_.preprocessFBBT_);
+    hs.Add(options_.passQuadObj_);
+    hs.Add(options_.passQuadCon_);
+    hs.Add(options_.passSOCPCones_);
+    hs.Add(options_.relax_);
+    GetModel().HashAcceptanceLevels(hs);
+    MPCD( HashOptions(hs) );
+    return hs.FinalizeHashValue();
+  }
+
+
+public:
+  /// Check solution \a x of the flat model, if requested.
+  /// Reports maximal violation per constraint type
+  /// (algebraic constraints only.)
+  /// Skipped when \a x does not cover all variables.
+  void CheckSolution(ArrayRef<double> x) {
+    if (!sol_check_report() || x.size() < (size_t)num_vars())
+      return;
+    GetModel().CheckSolution(x, sol_check_feastol(), 0, GetEnv());
+  }
+
+  //////////////////////////// IN-PLACE UPDATES /////////////////////////////
+  /// Whether the flat model consists of just \a n_vars original
+  /// variables and \a n_cons original range linear constraints,
+  /// all passed unchanged to a ModelAPI accepting updates.
+  /// Then their bounds and the linear objectives can be updated
+  /// in place by UpdateVarBounds() etc.
+  bool IfCanUpdateInPlace(int n_vars, int n_cons) const {
+    if (!ModelAPI::AcceptsModelUpdates() || num_vars()!=n_vars)
+      return false;
+    const auto& ck = GET_CONST_CONSTRAINT_KEEPER(LinConRange);
+    return n_cons == ck.GetNumberOfItems() &&
+        n_cons == ck.GetNumberOfAddable() &&
+        n_cons == GetModel().GetNumberOfAddable();
+  }
+
+  /// Update bounds of variables \a vars, also in the ModelAPI
+  void UpdateVarBounds(const std::vector<int>& vars,
+                       const std::vector<double>& lbs,
+                       const std::vector<double>& ubs) {
+    for (size_t k=0; k<vars.size(); ++k) {
+      set_var_lb(vars[k], lbs[k]);
+      set_var_ub(vars[k], ubs[k]);
+    }
+    GetModelAPI().UpdateVarBounds(vars, lbs, ubs);
+  }
+
+  /// Update ranges of range linear constraints \a cons,
+  /// also in the ModelAPI
+  void UpdateLinConRanges(const std::vector<int>& cons,
+                          const std::vector<double>& lbs,
+                          const std::vector<double>& ubs) {
+    auto& ck = GET_CONSTRAINT_KEEPER(LinConRange);
+    for (size_t k=0; k<cons.size(); ++k)
+      ck.GetConstraint(cons[k]).set_range(lbs[k], ubs[k]);
+    GetModelAPI().UpdateLinConRanges(cons, lbs, ubs);
+  }
+
+  /// Replace linear objective \a i, also in the ModelAPI
+  void UpdateLinearObjective(int i, LinearObjective&& lo) {
+    auto& obj = this->get_objectives().at(i);
+    obj = QuadraticObjective{ std::move(lo), {} };
+    GetModelAPI().SetLinearObjective(i, obj);
   }
 
   /// Fill model traits for license check.
@@ -543,6 +791,7 @@ protected:
   }
 
   void PrepareConversion() {
+    value_presolver_.SetPostsolveThreads(options_.postsolveThreads_);
   }
 
   void WindupConversion() {
@@ -828,12 +1077,20 @@ private:
     int preprocessAnything_ = 1;
     int preprocessEqualityResultBounds_ = 1;
     int preprocessEqualityBvar_ = 1;
+    int preprocessFBBT_ = 1;
 
     int passQuadObj_ = ModelAPIAcceptsQuadObj();
 		int passQuadCon_ = ModelAPIAcceptsQC();
 		int passSOCPCones_ = 0;
 
     int relax_ = 0;
+
+    int postsolveThreads_ = 1;
+
+    int solCheckReport_ = 0;
+    double solCheckFeasTol_ = 1e-6;
+
+    std::string cacheDir_;
   };
   Options options_;
 
@@ -846,6 +1103,12 @@ protected:
   /// Whether we should relax integrality
   int relax() const { return options_.relax_; }
 
+  /// Whether to check solutions
+  int sol_check_report() const { return options_.solCheckReport_; }
+
+  /// Solution check tolerance
+  double sol_check_feastol() const { return options_.solCheckFeasTol_; }
+
 
 public:
   /// Init FlatConverter options
@@ -872,6 +1135,12 @@ private:
     GetEnv().AddOption("cvt:pre:eqbinary",
         "0/1*: Preprocess reified equality comparison with a binary variable.",
         options_.preprocessEqualityBvar_, 0, 1);
+    GetEnv().AddOption("cvt:pre:fbbt",
+        "0/1*: Propagate variable bounds through linear, quadratic, "
+        "min, max, and abs constraints before the conversions "
+        "(feasibility-based bound tightening.) Tighter bounds "
+        "give smaller big-M values and piecewise-linear domains.",
+        options_.preprocessFBBT_, 0, 1);
     GetEnv().AddOption("cvt:quadobj passquadobj",
                        ModelAPIAcceptsQuadObj() ?
         "0/1*: Multiply out and pass quadratic objective terms to the solver, "
@@ -900,6 +1169,28 @@ private:
 		GetEnv().AddOption("alg:relax relax",
         "0*/1: Whether to relax integrality of variables.",
         options_.relax_, 0, 1);
+    GetEnv().AddOption("sol:postsolve:threads postsolve:threads",
+        "Number of threads to postsolve a solution pool: "
+        "0: number of hardware threads; 1 (default): no multithreading. "
+        "Each thread needs memory for a copy of all solution "
+        "and suffix values of the conversion graph.",
+        options_.postsolveThreads_, 0, 1024);
+    GetEnv().AddOption("sol:chk:report chk:report",
+        "0*/1: Whether to check the solver's solution against the "
+        "algebraic constraints passed to it and report "
+        "maximal violation per constraint type.",
+        options_.solCheckReport_, 0, 1);
+    GetEnv().AddOption("sol:chk:feastol chk:feastol",
+        "Feasibility tolerance for the solution check, default 1e-6.",
+        options_.solCheckFeasTol_, 0.0, 1e100);
+    GetEnv().AddStoredOption("cvt:cache",
+        "Directory to cache converted models in (default: none.) "
+        "A model is looked up by the contents of the NL file "
+        "and the options affecting its conversion; on a hit, "
+        "the conversion is skipped. "
+        "The cache files are specific to the machine and solver "
+        "and are never removed automatically.",
+        options_.cacheDir_);
   }
 
 
@@ -918,6 +1209,10 @@ public:
   bool IfPreproEqBinVar() const
   { return MPCD( CanPreprocess(options_.preprocessEqualityBvar_) ); }
 
+  /// Whether to propagate variable bounds before the conversions
+  bool IfPreproFBBT() const
+  { return MPCD( CanPreprocess(options_.preprocessFBBT_) ); }
+
   /// Whether we pass quad obj terms to the solver without linearization
   bool IfPassQuadObj() const { return options_.passQuadObj_; }
 
@@ -934,6 +1229,24 @@ public:
 	/// Whether we pass SOCP cones
 	bool IfPassSOCPCones() const { return options_.passSOCPCones_; }
 
+  /// Whether to probe indicator bodies' bounds for big-M.
+  /// Off by default, see MIPFlatConverter
+  bool IfProbeBigM() const { return false; }
+
+  /// Narrow bounds \a bnds of an indicator's \a body by
+  /// bound propagation with \a var fixed to \a val,
+  /// if IfProbeBigM()
+  void NarrowBoundsByProbing(int var, double val, const LinTerms& body,
+                             PreprocessInfoStd& bnds) {
+    double lo, hi;
+    if (MPCD( IfProbeBigM() ) &&
+        bound_prop_.ProbeBounds(var, val, body, lo, hi) &&
+        (lo > bnds.lb() || hi < bnds.ub())) {
+      bnds.narrow_result_bounds(lo, hi);
+      ++n_probe_narrowed_;
+    }
+  }
+
 
 public:
   /// Typedef ModelAPIType. For tests
@@ -959,18 +1272,32 @@ private:
       graph_exporter_app_->Append(s);
     }
   };
+  /// Solution checker functor
+  pre::ValuePresolver::SolCheckerFn sol_checker_fn_{
+    [this](ArrayRef<double> x){
+      MPD( CheckSolution(x) );
+    }
+  };
   /// ValuePresolver: should be init before constraint keepers
   /// and links
-  pre::ValuePresolver value_presolver_{GetEnv(), graph_exporter_fn_};
+  pre::ValuePresolver value_presolver_{GetEnv(), graph_exporter_fn_,
+                                       sol_checker_fn_};
   pre::CopyLink copy_link_ { GetValuePresolver() }; // the copy links
   pre::One2ManyLink one2many_link_ { GetValuePresolver() }; // the 1-to-many links
   pre::NodeRange auto_link_src_item_;   // the source item for autolinking
   std::vector<pre::NodeRange> auto_link_targ_items_;
 
 	ConicConverter<Impl> conic_cvt_ { *static_cast<Impl*>(this) };
+	BoundPropagator<Impl> bound_prop_ { *static_cast<Impl*>(this) };
+  int n_probe_narrowed_ = 0;
 
 	std::vector<int> refcnt_vars_;
 
+  /// Model cache: input key, whether set, whether read from cache
+  std::size_t input_cache_key_ = 0;
+  bool f_input_cache_key_ = false;
+  bool model_cache_hit_ = false;
+
 
 protected:
   /////////////////////// CONSTRAINT KEEPERS /////////////////////////
@@ -1113,9 +1440,7 @@ protected:
   /// @return constraint index, or -1
   template <class Constraint>
   int MapFind__Impl(const Constraint& con) {
-    const auto& map = GET_CONST_CONSTRAINT_MAP(Constraint);
-    auto it = map.find( con );
-    return (map.end() != it) ? it->second : -1;
+    return GET_CONST_CONSTRAINT_MAP(Constraint).Find(con);
   }
 
   /// MapInsert__Impl.
@@ -1125,9 +1450,7 @@ protected:
   /// @return false when inserted a duplicate (should not happen)
   template <class Constraint>
   bool MapInsert__Impl(const Constraint& con, int i) {
-    auto& map = GET_CONSTRAINT_MAP(Constraint);
-    auto result = map.insert( { con, i } );
-    return result.second;
+    return GET_CONSTRAINT_MAP(Constraint).Insert(con, i);
   }
 
 
@@ -221,6 +221,28 @@ protected:
     this->AddUnbridgedConstraintsToBackend(backend);
   }
 
+public:
+  ///////////////////////////// SERIALIZATION ////////////////////////////
+  /// Serialize variables, objectives, and constraints
+  void SerializeModel(BinaryWriter& wrt) const {
+    Serialize(wrt, var_lb_);
+    Serialize(wrt, var_ub_);
+    Serialize(wrt, var_type_);
+    Serialize(wrt, objs_);
+    SerializeConstraints(wrt);
+  }
+
+  /// Replace the model by a deserialized one
+  void DeserializeModel(BinaryReader& rd) {
+    var_lb_ = Deserialize(rd, (VarBndVec*)nullptr);
+    var_ub_ = Deserialize(rd, (VarBndVec*)nullptr);
+    var_type_ = Deserialize(rd, (VarTypeVec*)nullptr);
+    if (!check_vars())
+      MP_RAISE("Model data: variable arrays do not match");
+    objs_ = Deserialize(rd, (ObjList*)nullptr);
+    DeserializeConstraints(rd);
+  }
+
 private:
   /// Variables' bounds
   VarBndVec var_lb_, var_ub_;
@@ -13,6 +13,24 @@
 
 namespace mp {
 
+/// Compute sum of c[i]*x[v[i]], i<n.
+/// Four independent partial sums let the gathers from x
+/// overlap and the compiler vectorize the loop
+inline double ComputeLinValue(
+    const double* c, const int* v, std::size_t n, const double* x) {
+  double s0=0.0, s1=0.0, s2=0.0, s3=0.0;
+  std::size_t i=0;
+  for ( ; i+4<=n; i+=4) {
+    s0 += c[i] * x[v[i]];
+    s1 += c[i+1] * x[v[i+1]];
+    s2 += c[i+2] * x[v[i+2]];
+    s3 += c[i+3] * x[v[i+3]];
+  }
+  for ( ; i<n; ++i)
+    s0 += c[i] * x[v[i]];
+  return (s0+s1) + (s2+s3);
+}
+
 /// Linear terms: c'x
 class LinTerms {
 public:
@@ -75,10 +93,7 @@ public:
 
   /// Compute value given a dense vector of variable values
   double ComputeValue(ArrayRef<double> x) const {
-    double s=0.0;
-    for (size_t i=coefs().size(); i--; )
-      s += coefs()[i] * x[vars()[i]];
-    return s;
+    return ComputeLinValue(pcoefs(), pvars(), size(), x.data());
   }
 
   /// Set coef
@@ -96,10 +111,10 @@ public:
   { coefs_.push_back(c); vars_.push_back(v); }
 
   /// Add another LinTerms
+  /// No exact reserve(): repeated adds grow geometrically
   void add(const LinTerms& le) {
-    reserve(size() + le.size());
-    for (size_t i=0; i<le.size(); ++i)
-      add_term(le.coefs_[i], le.vars_[i]);
+    coefs_.insert(coefs_.end(), le.coefs_.begin(), le.coefs_.end());
+    vars_.insert(vars_.end(), le.vars_.begin(), le.vars_.end());
   }
 
   /// Add terms from a vector of pairs {c, v}
@@ -147,6 +162,81 @@ private:
 };
 
 
+/// Accumulator of linear terms.
+///
+/// Sums up coefficients in place: a dense coefficient array
+/// indexed by variable, plus the sparse list of touched variables.
+/// Meant to be reused: MoveOut() and clear() reset only
+/// the touched entries.
+class LinTermsAccumulator {
+public:
+  /// Add term c*x[v]
+  void add_term(double c, int v) {
+    assert(v>=0);
+    if ((std::size_t)v >= coefs_.size()) {
+      auto sz = std::max((std::size_t)v+1, 2*coefs_.size());
+      coefs_.resize(sz, 0.0);
+      is_touched_.resize(sz, 0);
+    }
+    if (!is_touched_[v]) {
+      is_touched_[v] = 1;
+      touched_.push_back(v);
+    }
+    coefs_[v] += c;
+  }
+
+  /// Add scale * lt
+  void add(const LinTerms& lt, double scale=1.0) {
+    for (std::size_t i=0; i<lt.size(); ++i)
+      add_term(scale * lt.coef(i), lt.var(i));
+  }
+
+  /// Nothing added?
+  bool empty() const { return touched_.empty(); }
+
+  /// Append the sum to \a lt, sorted by variable and without 0's,
+  /// and reset.
+  /// Many touched variables: scan the dense array, otherwise
+  /// sort the touched list
+  void MoveOut(LinTerms& lt) {
+    if (touched_.size() * 8 >= coefs_.size()) {
+      for (std::size_t v=0; v<coefs_.size(); ++v)
+        if (is_touched_[v])
+          MoveOutTerm(lt, (int)v);
+    } else {
+      std::sort(touched_.begin(), touched_.end());
+      for (int v: touched_)
+        MoveOutTerm(lt, v);
+    }
+    touched_.clear();
+  }
+
+  /// Reset
+  void clear() {
+    for (int v: touched_) {
+      coefs_[v] = 0.0;
+      is_touched_[v] = 0;
+    }
+    touched_.clear();
+  }
+
+
+protected:
+  void MoveOutTerm(LinTerms& lt, int v) {
+    if (0.0 != std::fabs(coefs_[v]))
+      lt.add_term(coefs_[v], v);
+    coefs_[v] = 0.0;
+    is_touched_[v] = 0;
+  }
+
+
+private:
+  std::vector<double> coefs_;
+  std::vector<char> is_touched_;
+  std::vector<int> touched_;
+};
+
+
 /// Typedef AffineExpr
 using AffineExpr = AlgebraicExpression<LinTerms>;
 
@@ -7,6 +7,23 @@
 
 namespace mp {
 
+/// Compute sum of c[i]*x[v1[i]]*x[v2[i]], i<n.
+/// Unrolled like ComputeLinValue()
+inline double ComputeQuadValue(const double* c,
+    const int* v1, const int* v2, std::size_t n, const double* x) {
+  double s0=0.0, s1=0.0, s2=0.0, s3=0.0;
+  std::size_t i=0;
+  for ( ; i+4<=n; i+=4) {
+    s0 += c[i] * x[v1[i]] * x[v2[i]];
+    s1 += c[i+1] * x[v1[i+1]] * x[v2[i+1]];
+    s2 += c[i+2] * x[v1[i+2]] * x[v2[i+2]];
+    s3 += c[i+3] * x[v1[i+3]] * x[v2[i+3]];
+  }
+  for ( ; i<n; ++i)
+    s0 += c[i] * x[v1[i]] * x[v2[i]];
+  return (s0+s1) + (s2+s3);
+}
+
 /// Quadratic terms x'Qx
 class QuadTerms {
 public:
@@ -55,10 +72,7 @@ public:
 
   /// Compute value given a dense vector of variable values
   double ComputeValue(ArrayRef<double> x) const {
-    double s=0.0;
-    for (size_t i=coefs().size(); i--; )
-      s += coefs()[i] * x[vars1()[i]] * x[vars2()[i]];
-    return s;
+    return ComputeQuadValue(pcoefs(), pvars1(), pvars2(), size(), x.data());
   }
 
   void add_term(double coef, int var1, int var2) {
@@ -79,8 +93,8 @@ public:
       cf = -cf;
   }
 
+  /// No exact reserve(): repeated adds grow geometrically
   void add(const QuadTerms& li) {
-    this->reserve(size() + li.size());
     /// eliminate duplicates when?
     coefs_.insert(coefs_.end(), li.coefs_.begin(), li.coefs_.end());
     vars1_.insert(vars1_.end(), li.vars1_.begin(), li.vars1_.end());
@@ -149,6 +163,9 @@ public:
   /// empty?
   bool empty() const { return GetLinTerms().empty() && GetQPTerms().empty(); }
 
+  /// Number of linear and quadratic terms
+  size_t size() const { return GetLinTerms().size() + GetQPTerms().size(); }
+
   /// is linear?
   bool is_linear() const { return GetQPTerms().empty(); }
 
@@ -184,6 +201,12 @@ public:
     QuadTerms::add(qlt.GetQPTerms());
   }
 
+  /// Multiply by const
+  void operator*=(double n) {
+    LinTerms::operator*=(n);
+    QuadTerms::operator*=(n);
+  }
+
   /// Value at given variable vector
   double ComputeValue(ArrayRef<double> x) const {
     return LinTerms::ComputeValue(x) + QuadTerms::ComputeValue(x);
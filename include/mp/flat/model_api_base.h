@@ -25,6 +25,7 @@
   */
 
 #include <string>
+#include <vector>
 
 #include "mp/arrayref.h"
 #include "mp/common.h"
@@ -100,6 +101,10 @@ enum ConstraintGroup {
 };
 
 
+/// Linear constraints in CSR format, see constr_algebraic.h
+class LinConBlock;
+
+
 /// ModelAPIs handling custom flat constraints should derive from
 class BasicFlatModelAPI {
 public:
@@ -141,6 +146,42 @@ public:
     MP_UNSUPPORTED("FlatModelAPI::SetQuadraticObjective()");
   }
 
+  /// Whether the ModelAPI accepts linear constraints in blocks,
+  /// see AddLinearConstraints(). Default: no, they are passed
+  /// one by one to AddConstraint()
+  static constexpr bool AcceptsLinConBlocks() { return false; }
+
+  /// Placeholder for AddLinearConstraints().
+  /// Called once for each natively accepted linear constraint type
+  /// if AcceptsLinConBlocks()
+  void AddLinearConstraints(const LinConBlock& ) {
+    MP_UNSUPPORTED("FlatModelAPI::AddLinearConstraints()");
+  }
+
+  /// Whether the ModelAPI can update an existing model in place,
+  /// see UpdateVarBounds() and UpdateLinConRanges().
+  /// Then objectives can also be set anew by SetLinearObjective().
+  /// Default: no, a changed model is built from scratch
+  static constexpr bool AcceptsModelUpdates() { return false; }
+
+  /// Placeholder for UpdateVarBounds(),
+  /// called for variables with changed bounds if AcceptsModelUpdates()
+  void UpdateVarBounds(const std::vector<int>& ,
+                       const std::vector<double>& ,
+                       const std::vector<double>& ) {
+    MP_UNSUPPORTED("FlatModelAPI::UpdateVarBounds()");
+  }
+
+  /// Placeholder for UpdateLinConRanges(),
+  /// called if AcceptsModelUpdates() for constraints with changed bounds.
+  /// Range linear constraints are indexed in the order
+  /// they were passed to the ModelAPI
+  void UpdateLinConRanges(const std::vector<int>& ,
+                          const std::vector<double>& ,
+                          const std::vector<double>& ) {
+    MP_UNSUPPORTED("FlatModelAPI::UpdateLinConRanges()");
+  }
+
   /// Placeholder for AddConstraint<>()
   template <class Constraint>
   void AddConstraint(const Constraint& ) {
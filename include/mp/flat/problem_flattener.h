@@ -2,6 +2,9 @@
 #define PROBLEM_FLATTENER_H
 
 #include <utility>
+#include <algorithm>
+#include <vector>
+#include <deque>
 #include <unordered_map>
 #include <map>
 #include <cmath>
@@ -13,6 +16,8 @@
 #include "mp/flat/constr_std.h"
 #include "mp/flat/obj_std.h"
 #include "mp/valcvt.h"
+#include "mp/utils-file.h"
+#include "mp/utils-hash-stream.h"
 
 
 namespace mp {
@@ -104,10 +109,88 @@ public:
   /// Convert the whole model, e.g., after reading from NL
   void ConvertModel() override {
     GetFlatCvt().StartModelInput();
-    MP_DISPATCH( ConvertStandardItems() );
+    if (!GetFlatCvt().ReadModelCache()) {
+      auto* prs = GetEnv().GetRunStats();
+      if (prs) {
+        prs->Set("model", "input", "vars", GetModel().num_vars());
+        prs->Set("model", "input", "objs", GetModel().num_objs());
+        prs->Set("model", "input", "algebraic_cons",
+                 GetModel().num_algebraic_cons());
+        prs->Set("model", "input", "logical_cons",
+                 GetModel().num_logical_cons());
+        prs->Set("model", "input", "common_exprs",
+                 GetModel().num_common_exprs());
+      }
+      {
+        ScopedRunTimer timer(prs, "phases", "ConvertStandardItems");
+        MP_DISPATCH( ConvertStandardItems() );
+      }
+      if (prs) {
+        prs->Set("model", "common_exprs", "inlined", num_cexprs_inlined_);
+        prs->Set("model", "common_exprs", "vars", num_cexprs_as_vars_);
+      }
+    }
     GetFlatCvt().FinishModelInput();      // Chance to flush to the Backend
   }
 
+  /// Set the model cache key from the NL file contents,
+  /// if the cache is on
+  void SetInputFile(const std::string& nl_filename) override {
+    if (!GetFlatCvt().IfModelCacheOn())
+      return;
+    std::string nl;
+    if (!ReadFileToString(nl_filename, nl))
+      return;
+    HashStreamer hs(std::hash<std::string>()(nl));
+    hs.Add(sos());
+    hs.Add(sos2_ampl_pl());
+    hs.Add(cexpr_inline_uses());
+    hs.Add(cexpr_inline_size());
+    GetFlatCvt().SetModelCacheKey(hs.FinalizeHashValue());
+  }
+
+  /// Update the converted model in place if \a new_model
+  /// differs only in variable bounds, constraint ranges
+  /// and linear objective coefficients, and these items
+  /// are passed unchanged to the ModelAPI.
+  /// Takes over these items, initial values and suffixes
+  /// from \a new_model.
+  bool UpdateModel(ProblemType& new_model) override {
+    auto diff = GetModel().Compare(new_model);
+    if (!diff.same_structure ||
+        !GetFlatCvt().IfCanUpdateInPlace(
+          GetModel().num_vars(), GetModel().num_algebraic_cons()))
+      return false;
+    if (diff.vars.size()) {
+      std::vector<double> lbs, ubs;
+      lbs.reserve(diff.vars.size());
+      ubs.reserve(diff.vars.size());
+      for (int i: diff.vars) {
+        lbs.push_back(new_model.var(i).lb());
+        ubs.push_back(new_model.var(i).ub());
+      }
+      GetFlatCvt().UpdateVarBounds(diff.vars, lbs, ubs);
+    }
+    if (diff.alg_cons.size()) {
+      std::vector<double> lbs, ubs;
+      lbs.reserve(diff.alg_cons.size());
+      ubs.reserve(diff.alg_cons.size());
+      for (int i: diff.alg_cons) {
+        lbs.push_back(new_model.algebraic_con(i).lb());
+        ubs.push_back(new_model.algebraic_con(i).ub());
+      }
+      GetFlatCvt().UpdateLinConRanges(diff.alg_cons, lbs, ubs);
+    }
+    for (int i: diff.objs) {
+      auto obj = new_model.obj(i);
+      auto le = ToLinTerms(obj.linear_expr());
+      GetFlatCvt().UpdateLinearObjective(i,
+          { obj.type(), std::move(le.coefs()), std::move(le.vars()) });
+    }
+    GetModel().Update(new_model, diff);
+    return true;
+  }
+
   /// Fill model traits
   void FillModelTraits(AMPLS_ModelTraits& mt) override {
     GetFlatCvt().FillModelTraits(mt);
@@ -127,6 +210,8 @@ protected:
 
     ////////////////////////// Common exprs
     int num_common_exprs = GetModel().num_common_exprs();
+    if (num_common_exprs && cexpr_inline_uses())
+      MP_DISPATCH( CountCommonExprUses() );
     for (int i = 0; i < num_common_exprs; ++i)
       MP_DISPATCH( Convert( GetModel().common_expr(i) ) );
 
@@ -175,6 +260,88 @@ protected:
     /// Converting on demand, see VisitCommonExpr
   }
 
+  /// Count references to each common expression
+  /// in all expression trees: objectives, constraints,
+  /// and common expressions themselves.
+  /// Non-recursive.
+  void CountCommonExprUses() {
+    InitCommonExprs();
+    std::vector<Expr> stack;
+    auto count = [this, &stack](Expr e) {
+      if (!e)
+        return;
+      stack.push_back(e);
+      while (!stack.empty()) {
+        auto e1 = stack.back();
+        stack.pop_back();
+        if (expr::COMMON_EXPR == e1.kind())
+          ++common_exprs_[Cast<Reference>(e1).index()].uses_;
+        else
+          PushExprArgs(e1, stack);
+      }
+    };
+    const auto& model = GetModel();
+    for (int i=0; i<model.num_common_exprs(); ++i)
+      count(model.common_expr(i).nonlinear_expr());
+    for (int i=0; i<model.num_objs(); ++i)
+      count(model.obj(i).nonlinear_expr());
+    for (int i=0; i<model.num_algebraic_cons(); ++i)
+      count(model.algebraic_con(i).nonlinear_expr());
+    for (int i=0; i<model.num_logical_cons(); ++i)
+      count(model.logical_con(i).expr());
+  }
+
+  /// Push the arguments of any expression \a e
+  static void PushExprArgs(Expr e, std::vector<Expr>& stack) {
+    if (auto ue = Cast<UnaryExpr>(e))
+      stack.push_back(ue.arg());
+    else if (auto be = Cast<BinaryExpr>(e))
+      PushBinaryArgs(be, stack);
+    else if (auto ie = Cast<IteratedExpr>(e))
+      stack.insert(stack.end(), ie.begin(), ie.end());
+    else if (auto ife = Cast<IfExpr>(e))
+      PushIfArgs(ife, stack);
+    else if (auto plt = Cast<PLTerm>(e))
+      stack.push_back(plt.arg());
+    else if (auto ce = Cast<CallExpr>(e))
+      stack.insert(stack.end(), ce.begin(), ce.end());
+    else if (auto ne = Cast<NotExpr>(e))
+      stack.push_back(ne.arg());
+    else if (auto ble = Cast<BinaryLogicalExpr>(e))
+      PushBinaryArgs(ble, stack);
+    else if (auto re = Cast<RelationalExpr>(e))
+      PushBinaryArgs(re, stack);
+    else if (auto lce = Cast<LogicalCountExpr>(e)) {
+      stack.push_back(lce.lhs());
+      stack.push_back(lce.rhs());
+    }
+    else if (auto imp = Cast<ImplicationExpr>(e))
+      PushIfArgs(imp, stack);
+    else if (auto ile = Cast<IteratedLogicalExpr>(e))
+      stack.insert(stack.end(), ile.begin(), ile.end());
+    else if (auto cnt = Cast<CountExpr>(e))
+      stack.insert(stack.end(), cnt.begin(), cnt.end());
+    else if (auto pwe = Cast<PairwiseExpr>(e))
+      stack.insert(stack.end(), pwe.begin(), pwe.end());
+    else if (auto sno = Cast<SymbolicNumberOfExpr>(e))
+      stack.insert(stack.end(), sno.begin(), sno.end());
+    else if (auto sie = Cast<SymbolicIfExpr>(e))
+      PushIfArgs(sie, stack);
+  }
+
+  template <class BinExpr>
+  static void PushBinaryArgs(BinExpr e, std::vector<Expr>& stack) {
+    stack.push_back(e.lhs());
+    stack.push_back(e.rhs());
+  }
+
+  template <class IfExprType>
+  static void PushIfArgs(IfExprType e, std::vector<Expr>& stack) {
+    stack.push_back(e.condition());
+    stack.push_back(e.then_expr());
+    stack.push_back(e.else_expr());
+  }
+
   /// Convert an objective
   void Convert(typename ProblemType::MutObjective obj) {
     auto obj_src =              // source value node for this obj
@@ -193,7 +360,7 @@ protected:
     NumericExpr e = obj.nonlinear_expr();
     EExpr eexpr;
     if (e) {
-      eexpr=MP_DISPATCH( Visit(e) );
+      eexpr=MP_DISPATCH( Convert2EExpr(e) );
       le.add(eexpr.GetLinTerms());
       if (std::fabs(eexpr.constant_term())!=0.0) {
         /// Not using objective constant, should we?
@@ -243,7 +410,7 @@ protected:
     pre_result.lt = ToLinTerms(con.linear_expr());
     EExpr ee;
     if (NumericExpr e = con.nonlinear_expr()) {
-      ee=MP_DISPATCH( Visit(e) );
+      ee=MP_DISPATCH( Convert2EExpr(e) );
       pre_result.lt.add(ee.GetLinTerms());
     }
     pre_result.compl_var = GetModel().GetComplementarityVariable(i)-1;  // -1
@@ -307,9 +474,16 @@ protected:
 protected:
   //////////////////////////////////// VISITOR ADAPTERS /////////////////////////////////////////
 
-  /// Convert an expression to an EExpr
+  /// Convert an expression to an EExpr.
+  /// Unless switched off by option cvt:expr:iterative,
+  /// uses the non-recursive walk: sums via AccumulateLinear(),
+  /// the rest via WalkExpr().
   EExpr Convert2EExpr(Expr e) {
-    return MP_DISPATCH(Visit(e));
+    if (!iterative_walk())
+      return MP_DISPATCH(Visit(e));
+    if (IfAccumulateLinear(e.kind()))
+      return AccumulateLinear(e);
+    return WalkExpr(e);
   }
 
   /// From an expression:
@@ -330,6 +504,333 @@ protected:
     return Convert2VarAsAffineExpr(std::move(ee));
   }
 
+  /// Whether AccumulateLinear() is used for a tree with this root
+  static bool IfAccumulateLinear(expr::Kind kind) {
+    return expr::ADD==kind || expr::SUB==kind ||
+        expr::MINUS==kind || expr::SUM==kind;
+  }
+
+  /// AccumulateLinear() stack entry: subexpression and its factor
+  struct LinFrame {
+    Expr e_;
+    double scale_;
+  };
+
+  /// Flatten a linear combination of subexpressions.
+  ///
+  /// Walks the +, -, unary minus, sum nodes of \a e, as well as
+  /// products with a numeric constant, on the explicit stack
+  /// lin_stack_, passing the scale factor down.
+  /// Variables are summed up in place in a LinTermsAccumulator
+  /// (one per nesting level, reused between calls);
+  /// other subexpressions are converted by WalkExpr()
+  /// in the original order, and their terms scaled and added.
+  /// The linear terms of the result are sorted and have no duplicates.
+  EExpr AccumulateLinear(Expr e) {
+    LinAccScope scope(*this);
+    auto& acc = scope.acc_;
+    EExpr result;
+    lin_stack_.push_back({e, 1.0});
+    while (lin_stack_.size() > scope.stack_size_) {
+      const auto fr = lin_stack_.back();
+      lin_stack_.pop_back();
+      switch (fr.e_.kind()) {
+      case expr::NUMBER:
+        result.add_to_constant(
+              fr.scale_ * Cast<NumericConstant>(fr.e_).value());
+        break;
+      case expr::VARIABLE:
+        acc.add_term(fr.scale_, Cast<Reference>(fr.e_).index());
+        break;
+      case expr::MINUS:
+        lin_stack_.push_back({Cast<UnaryExpr>(fr.e_).arg(), -fr.scale_});
+        break;
+      case expr::ADD:
+      case expr::SUB: {
+        auto be = Cast<BinaryExpr>(fr.e_);
+        lin_stack_.push_back({be.rhs(),
+                              expr::SUB==fr.e_.kind() ? -fr.scale_ : fr.scale_});
+        lin_stack_.push_back({be.lhs(), fr.scale_});
+      } break;
+      case expr::SUM: {
+        auto se = Cast<typename BaseExprVisitor::SumExpr>(fr.e_);
+        for (int i=se.num_args(); i--; )
+          lin_stack_.push_back({se.arg(i), fr.scale_});
+      } break;
+      case expr::MUL: {
+        auto be = Cast<BinaryExpr>(fr.e_);
+        if (expr::NUMBER == be.lhs().kind()) {
+          lin_stack_.push_back({be.rhs(),
+              fr.scale_ * Cast<NumericConstant>(be.lhs()).value()});
+          break;
+        }
+        if (expr::NUMBER == be.rhs().kind()) {
+          lin_stack_.push_back({be.lhs(),
+              fr.scale_ * Cast<NumericConstant>(be.rhs()).value()});
+          break;
+        }
+        AddWalkResult(fr, acc, result);
+      } break;
+      default:
+        AddWalkResult(fr, acc, result);
+      }
+    }
+    acc.MoveOut(result.GetLinTerms());
+    return result;
+  }
+
+  /// Convert a subexpression by WalkExpr(),
+  /// add its scaled terms to \a acc and \a result
+  void AddWalkResult(const LinFrame& fr,
+                     LinTermsAccumulator& acc, EExpr& result) {
+    auto ee = WalkExpr(fr.e_);               // can reenter
+    acc.add(ee.GetLinTerms(), fr.scale_);
+    if (ee.GetQPTerms().size()) {
+      if (1.0 != fr.scale_)
+        ee.GetQPTerms() *= fr.scale_;
+      result.GetQPTerms().add(ee.GetQPTerms());
+    }
+    result.add_to_constant(fr.scale_ * ee.constant_term());
+  }
+
+  /// Takes the accumulator of the next nesting level
+  /// for AccumulateLinear(), restores the stack on exit
+  struct LinAccScope {
+    LinAccScope(ProblemFlattener& pf) :
+      pf_(pf), stack_size_(pf.lin_stack_.size()),
+      acc_(pf.GetLinAccumulator(pf.lin_acc_level_++)) { }
+    ~LinAccScope() {
+      pf_.lin_stack_.resize(stack_size_);
+      acc_.clear();
+      --pf_.lin_acc_level_;
+    }
+    ProblemFlattener& pf_;
+    const std::size_t stack_size_;
+    LinTermsAccumulator& acc_;
+  };
+
+  /// Linear accumulator of nesting level \a i
+  LinTermsAccumulator& GetLinAccumulator(int i) {
+    while ((int)lin_accs_.size() <= i)
+      lin_accs_.emplace_back();
+    return lin_accs_[i];
+  }
+
+  /// Iterative postorder expression walk.
+  ///
+  /// Chain-prone expressions (unary minus, +, -, *, sum,
+  /// if-then-else) are expanded on the explicit stack walk_stack_,
+  /// so that deep chains do not overflow the call stack.
+  /// Intermediate results are kept in the pools eexpr_pool_
+  /// (scaled EExpr's) and var_pool_ (result variables of
+  /// if-then-else arguments), and combined in place:
+  /// the smaller operand is added into the larger one,
+  /// and negations only flip the scale factor.
+  /// Other expressions are handed over to the recursive Visit(),
+  /// which calls back into WalkExpr() for their arguments.
+  /// The order of model item creation is the same as with Visit().
+  /// Reentrant: each call only works above the current
+  /// stack and pool sizes.
+  EExpr WalkExpr(Expr e) {
+    WalkScope scope(*this);
+    walk_stack_.push_back({e, false, false});
+    while (walk_stack_.size() > scope.stack_size_) {
+      auto& fr = walk_stack_.back();
+      const auto e_cur = fr.e_;
+      const bool to_var = fr.to_var_;
+      if (fr.expanded_) {
+        walk_stack_.pop_back();
+        CombineWalkResults(e_cur);
+      } else if (IfExpandInWalk(e_cur.kind())) {
+        fr.expanded_ = true;
+        PushWalkArgs(e_cur);
+        continue;
+      } else {
+        walk_stack_.pop_back();             // Visit() can reenter
+        eexpr_pool_.push_back( { MP_DISPATCH( Visit(e_cur) ) } );
+      }
+      if (to_var) {
+        auto var = Convert2Var( PopWalkResult() );
+        var_pool_.push_back(var);
+      }
+    }
+    assert(eexpr_pool_.size() == scope.eexpr_pool_size_+1);
+    assert(var_pool_.size() == scope.var_pool_size_);
+    return PopWalkResult();
+  }
+
+  /// Whether WalkExpr() expands expressions of this kind itself
+  static bool IfExpandInWalk(expr::Kind kind) {
+    switch (kind) {
+    case expr::MINUS:
+    case expr::ADD:
+    case expr::SUB:
+    case expr::MUL:
+    case expr::SUM:
+    case expr::IF:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  /// Push the arguments of \a e on the walk stack,
+  /// in reverse order so that they are converted in the natural order
+  void PushWalkArgs(Expr e) {
+    switch (e.kind()) {
+    case expr::MINUS:
+      walk_stack_.push_back({Cast<UnaryExpr>(e).arg(), false, false});
+      break;
+    case expr::ADD:
+    case expr::SUB:
+    case expr::MUL: {
+      auto be = Cast<BinaryExpr>(e);
+      walk_stack_.push_back({be.rhs(), false, false});
+      walk_stack_.push_back({be.lhs(), false, false});
+    } break;
+    case expr::SUM: {
+      auto se = Cast<typename BaseExprVisitor::SumExpr>(e);
+      for (int i=se.num_args(); i--; )
+        walk_stack_.push_back({se.arg(i), false, false});
+    } break;
+    case expr::IF: {
+      auto ie = Cast<IfExpr>(e);
+      walk_stack_.push_back({ie.else_expr(), false, true});
+      walk_stack_.push_back({ie.then_expr(), false, true});
+      walk_stack_.push_back({ie.condition(), false, true});
+    } break;
+    default:
+      MP_RAISE(fmt::format("WalkExpr: unexpected expression kind {}",
+                           str(e.kind())));
+    }
+  }
+
+  /// Combine the converted arguments of \a e from the pools
+  /// into its result on top of eexpr_pool_.
+  /// Same operations as the corresponding Visit...() methods.
+  void CombineWalkResults(Expr e) {
+    switch (e.kind()) {
+    case expr::MINUS:
+      eexpr_pool_.back().scale_ *= -1.0;
+      break;
+    case expr::ADD:
+    case expr::SUB:
+      if (expr::SUB == e.kind())
+        eexpr_pool_.back().scale_ *= -1.0;
+      AddUpWalkResults(2);
+      break;
+    case expr::MUL: {
+      auto er = PopWalkResult();
+      auto el = PopWalkResult();              // can reenter
+      eexpr_pool_.push_back( { QuadratizeOrLinearize( el, er ) } );
+    } break;
+    case expr::SUM: {
+      const auto n_args =
+          Cast<typename BaseExprVisitor::SumExpr>(e).num_args();
+      if (0 == n_args)
+        eexpr_pool_.emplace_back();
+      else
+        AddUpWalkResults(n_args);
+    } break;
+    case expr::IF: {
+      IfThenConstraint itc;
+      auto& args = itc.GetArguments();
+      std::copy(var_pool_.end()-3, var_pool_.end(), args.begin());
+      var_pool_.resize(var_pool_.size()-3);
+      eexpr_pool_.push_back( { AssignResult2Args( std::move(itc) ) } );
+    } break;
+    default:
+      MP_RAISE(fmt::format("WalkExpr: unexpected expression kind {}",
+                           str(e.kind())));
+    }
+  }
+
+  /// Sum up the top \a n entries of eexpr_pool_ into one.
+  /// The smaller ones are added into the largest one,
+  /// e.g., in x+(y+(z+...)). Terms order does not matter.
+  void AddUpWalkResults(std::size_t n) {
+    assert(n && n <= eexpr_pool_.size());
+    const auto i0 = eexpr_pool_.size() - n;
+    auto i_max = i0;
+    for (auto i=i0+1; i!=eexpr_pool_.size(); ++i)
+      if (NumTerms(eexpr_pool_[i_max].ee_) < NumTerms(eexpr_pool_[i].ee_))
+        i_max = i;
+    if (i_max != i0)
+      std::swap(eexpr_pool_[i0], eexpr_pool_[i_max]);
+    auto& sum = eexpr_pool_[i0];
+    for (auto i=i0+1; i!=eexpr_pool_.size(); ++i) {
+      auto& term = eexpr_pool_[i];
+      if (term.scale_ != sum.scale_)
+        term.ee_ *= term.scale_ / sum.scale_;
+      sum.ee_.add(term.ee_);
+    }
+    eexpr_pool_.resize(i0+1);
+  }
+
+  /// Pop the top result of eexpr_pool_, applying its scale
+  EExpr PopWalkResult() {
+    auto& top = eexpr_pool_.back();
+    EExpr result = std::move(top.ee_);
+    if (1.0 != top.scale_)
+      result *= top.scale_;
+    eexpr_pool_.pop_back();
+    return result;
+  }
+
+  /// Whether to inline a converted common expression
+  /// with \a n_uses references (0 if not counted), or to make
+  /// it a variable.
+  /// Inline affine ones with at most cvt:expr:inlineuses uses
+  /// and at most cvt:expr:inlinesize terms, and all constants.
+  bool IfInlineCommonExpr(EExpr& ee, int n_uses) {
+    if (!cexpr_inline_uses() || !ee.is_affine())
+      return false;
+    ee.sort_terms();
+    if (ee.is_constant())
+      return true;
+    return n_uses <= cexpr_inline_uses() &&
+        (int)ee.GetLinTerms().size() <= cexpr_inline_size();
+  }
+
+  /// Number of linear and quadratic terms
+  static std::size_t NumTerms(const EExpr& ee)
+  { return ee.GetLinTerms().size() + ee.GetQPTerms().size(); }
+
+  /// eexpr_pool_ entry: scale_ * ee_
+  struct ScaledEExpr {
+    ScaledEExpr() = default;
+    ScaledEExpr(EExpr&& ee) : ee_(std::move(ee)) { }
+    EExpr ee_;
+    double scale_ = 1.0;
+  };
+
+  /// WalkExpr() frame: expression, whether its arguments
+  /// are already on the stack, whether to convert its result
+  /// to a variable (into var_pool_)
+  struct WalkFrame {
+    Expr e_;
+    bool expanded_;
+    bool to_var_;
+  };
+
+  /// Restores the walk stack and pools on exit from WalkExpr(),
+  /// also when an exception is thrown
+  struct WalkScope {
+    WalkScope(ProblemFlattener& pf) :
+      pf_(pf), stack_size_(pf.walk_stack_.size()),
+      eexpr_pool_size_(pf.eexpr_pool_.size()),
+      var_pool_size_(pf.var_pool_.size()) { }
+    ~WalkScope() {
+      pf_.walk_stack_.resize(stack_size_);
+      pf_.eexpr_pool_.resize(eexpr_pool_size_);
+      pf_.var_pool_.resize(var_pool_size_);
+    }
+    ProblemFlattener& pf_;
+    const std::size_t stack_size_;
+    const std::size_t eexpr_pool_size_;
+    const std::size_t var_pool_size_;
+  };
+
   /// Generic functional expression array visitor.
   /// Assumes the arguments should be converted to variables.
   /// Can produce a new result variable/expression and
@@ -419,22 +920,32 @@ public:          // need to be public due to CRTP
     return EExpr::Variable{ r.index() };
   }
 
+  /// Common expressions are converted on first use.
+  /// Short affine ones with few uses are inlined,
+  /// see IfInlineCommonExpr(), the rest become variables.
   EExpr VisitCommonExpr(Reference r) {
     const auto index = r.index();
-    if (index >= (int)common_exprs_.size()) {
-      assert(index < GetModel().num_common_exprs());
-      common_exprs_.resize(
-                  GetModel().num_common_exprs(),
-                  -1);          // init by -1, "no variable"
-    }
-    if (common_exprs_[index]<0) {                 // not yet converted
+    if (index >= (int)common_exprs_.size())
+      InitCommonExprs();
+    if (!common_exprs_[index].IsConverted()) {
       auto ce = MP_DISPATCH( GetModel() ).common_expr(index);
       EExpr eexpr( ToLinTerms(ce.linear_expr()) );
       if (ce.nonlinear_expr())
         eexpr.add( Convert2EExpr(ce.nonlinear_expr()) );
-      common_exprs_[index] = Convert2Var(std::move(eexpr));
+      auto& cei = common_exprs_[index];
+      if (IfInlineCommonExpr(eexpr, cei.uses_)) {
+        cei.ee_ = std::move(eexpr);
+        cei.inline_ = true;
+        ++num_cexprs_inlined_;
+      } else {
+        cei.var_ = Convert2Var(std::move(eexpr));
+        ++num_cexprs_as_vars_;
+      }
     }
-    return EExpr::Variable{ common_exprs_[index] };
+    const auto& cei = common_exprs_[index];
+    if (cei.inline_)
+      return cei.ee_;
+    return EExpr::Variable{ cei.var_ };
   }
 
   EExpr VisitMinus(UnaryExpr e) {
@@ -915,7 +1426,40 @@ protected:
 
 
 private:
-  std::vector<int> common_exprs_;               // should be in FlatModel
+  /// Conversion info of a common expression
+  struct CommonExprInfo {
+    /// Number of references, if counted
+    int uses_ = 0;
+    /// Result variable
+    int var_ = -1;
+    /// Inlined?
+    bool inline_ = false;
+    /// The inlined expression
+    EExpr ee_;
+
+    bool IsConverted() const { return inline_ || var_>=0; }
+  };
+
+  /// Allocate info for all common expressions
+  void InitCommonExprs() {
+    if (common_exprs_.size() < (std::size_t)GetModel().num_common_exprs())
+      common_exprs_.resize(GetModel().num_common_exprs());
+  }
+
+  std::vector<CommonExprInfo> common_exprs_;    // should be in FlatModel
+  int num_cexprs_inlined_ = 0;
+  int num_cexprs_as_vars_ = 0;
+
+  /// WalkExpr() stack and result pools, reused between calls
+  std::vector<WalkFrame> walk_stack_;
+  std::vector<ScaledEExpr> eexpr_pool_;
+  std::vector<int> var_pool_;
+
+  /// AccumulateLinear() stack and accumulators by nesting level.
+  /// Deque: references stay valid when growing
+  std::vector<LinFrame> lin_stack_;
+  std::deque<LinTermsAccumulator> lin_accs_;
+  int lin_acc_level_ = 0;
 
   int ifFltCon_ = -1;   // -1: undefined, 0: walking an expr tree in an objective,
                         // 1: in a constraint
@@ -940,6 +1484,9 @@ private:
   struct Options {
     int sos_ = 1;
     int sos2_ = 1;
+    int iterative_walk_ = 1;
+    int cexpr_inline_uses_ = 1;
+    int cexpr_inline_size_ = 16;
   };
   Options options_;
 
@@ -947,6 +1494,9 @@ private:
 protected:
   int sos() const { return options_.sos_; }
   int sos2_ampl_pl() const { return options_.sos2_; }
+  int iterative_walk() const { return options_.iterative_walk_; }
+  int cexpr_inline_uses() const { return options_.cexpr_inline_uses_; }
+  int cexpr_inline_size() const { return options_.cexpr_inline_size_; }
 
   /// Distinguish between constraints and objectives.
   /// What about common expressions?
@@ -981,6 +1531,23 @@ private:
         "piecewise-linear terms, using suffixes .sos and .sosref "
         "provided by AMPL.",
         options_.sos2_, 0, 1);
+    GetEnv().AddOption("cvt:expr:iterative",
+        "0/1*: Whether to flatten expression trees with a non-recursive "
+        "walk, which handles arbitrarily deep chains of "
+        "+, -, *, sum and if-then-else. "
+        "With 0, use the recursive visitor.",
+        options_.iterative_walk_, 0, 1);
+    GetEnv().AddOption("cvt:expr:inlineuses",
+        "Inline affine common expressions (defined variables) with at most "
+        "this many uses and at most cvt:expr:inlinesize terms "
+        "into their consumers, rather than creating an auxiliary variable "
+        "and a linear equality. Constant ones are always inlined. "
+        "0: never inline. Default 1.",
+        options_.cexpr_inline_uses_, 0, 1000000);
+    GetEnv().AddOption("cvt:expr:inlinesize",
+        "Maximal number of linear terms of an inlined common expression, "
+        "see cvt:expr:inlineuses. Default 16.",
+        options_.cexpr_inline_size_, 0, 1000000);
   }
 
 
@@ -300,13 +300,30 @@ public:
   double bigMDefault() const { return options_.bigM_default_; }
   double PLApproxRelTol() const { return options_.PLApproxRelTol_; }
   double PLApproxDomain() const { return options_.PLApproxDomain_; }
+  int PLApproxThreads() const { return options_.PLApproxThreads_; }
+
+  /// Whether to probe indicator bodies' bounds for big-M
+  bool IfProbeBigM() const { return options_.bigMProbe_; }
+
+  /// Add MIP options to the model cache key.
+  /// The PL approximation threads do not affect the model
+  void HashOptions(HashStreamer& hs) const {
+    BaseConverter::HashOptions(hs);
+    hs.Add(options_.cmpEps_);
+    hs.Add(options_.bigM_default_);
+    hs.Add(options_.bigMProbe_);
+    hs.Add(options_.PLApproxRelTol_);
+    hs.Add(options_.PLApproxDomain_);
+  }
 
 private:
   struct Options {
     double cmpEps_ { 1e-4 };
     double bigM_default_ { -1 };
+    int bigMProbe_ { 1 };
     double PLApproxRelTol_ { 1e-2 };
     double PLApproxDomain_ { 1e6 };
+    int PLApproxThreads_ { 0 };
   };
   Options options_;
 
@@ -320,6 +337,13 @@ private:
                        "Not used by default. Use with care (prefer tight bounds). "
                        "Should be smaller than (1.0 / [integrality tolerance])",
                        options_.bigM_default_, -1.0, 1e100);
+    this->GetEnv().AddOption("cvt:mip:probe cvt:bigM:probe",
+                       "0/1*: Tighten big-M values of indicator constraint "
+                       "linearizations by bound propagation with the "
+                       "indicator's binary variable fixed to its inactive "
+                       "value. Results are cached per body. "
+                       "Requires cvt:pre:fbbt=1.",
+                       options_.bigMProbe_, 0, 1);
     this->GetEnv().AddOption("cvt:plapprox:reltol plapprox:reltol plapproxreltol",
                        "Relative tolerance for piecewise-linear approximation. Default 0.01.",
                        options_.PLApproxRelTol_, 0.0, 1e100);
@@ -327,6 +351,12 @@ private:
                        "For piecewise-linear approximated functions, both arguments and result "
                        "are bounded to +-[pladomain]. Default 1e6.",
                        options_.PLApproxDomain_, 0.0, 1e100);
+    this->GetEnv().AddOption("cvt:plapprox:threads plapprox:threads",
+                       "Number of threads for piecewise-linear approximation "
+                       "of large batches of functions. Default 0: number of "
+                       "hardware threads; 1: no multithreading. The resulting "
+                       "model does not depend on this value.",
+                       options_.PLApproxThreads_, 0, 1024);
   }
 };
 
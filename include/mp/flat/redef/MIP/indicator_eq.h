@@ -23,6 +23,9 @@ public:
     auto binvar=indc.get_binary_var();
     auto bnds = GetMC().ComputeBoundsAndType(
           indc.get_constraint().GetBody());
+    GetMC().NarrowBoundsByProbing(       // bounds when b!=val
+          binvar, 1-indc.get_binary_value(),
+          indc.get_constraint().GetBody(), bnds);
     /// Converting b==val ==> c'x==d to
     ///   ==> c'x <= d and
     ///   ==> c'x >= d
@@ -24,6 +24,9 @@ public:
     auto binvar=indc.get_binary_var();
     auto bnds = GetMC().ComputeBoundsAndType(
           indc.get_constraint().GetBody());
+    GetMC().NarrowBoundsByProbing(       // bounds when b!=val
+          binvar, 1-indc.get_binary_value(),
+          indc.get_constraint().GetBody(), bnds);
     ConvertImplicationGE(binvar, indc.get_binary_value(),
                          bnds.lb(), indc.get_constraint());
   }
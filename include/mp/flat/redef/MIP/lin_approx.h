@@ -5,6 +5,11 @@
  *  via piecewise-linear approximation
  */
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <unordered_map>
+
 #include "mp/common.h"
 
 #include "mp/flat/redef/redef_base.h"
@@ -40,25 +45,24 @@ public:
   using ItemType = FuncCon;
 
   /// Convert in any context
-  void Convert(const ItemType& con, int ) {
+  void Convert(const ItemType& con, int i) {
     assert(!con.GetContext().IsNone());
     assert(1==con.GetArguments().size());          // 1 argument var
     auto x = con.GetArguments()[0];
     auto y = con.GetResultVar();
-    PLApproxParams laPrm;
-    laPrm.ubErr = GetMC().PLApproxRelTol();
-    auto dm = GetMC().PLApproxDomain();
-    /// Narrow graph domain to +-dm
-    laPrm.grDom.lbx = std::max(GetMC().lb(x), -dm);
-    laPrm.grDom.ubx = std::min(GetMC().ub(x), dm);
-    laPrm.grDom.lby = std::max(GetMC().lb(y), -dm);
-    laPrm.grDom.uby = std::min(GetMC().ub(y), dm);
-    laPrm.is_x_int = GetMC().is_var_integer(x);
+    PLApproxParams laPrm = MakeApproxParams(con);
 
     auto warn = GetWarningKeyAndText(con.GetTypeName(), laPrm.ubErr);
     GetMC().AddWarning( warn.first, warn.second );
 
-    PLApproximate(con, laPrm);
+    auto it_prep = prepared_.find(i);
+    if (prepared_.end() != it_prep &&
+        SameApproxInput(it_prep->second.first, laPrm))
+      laPrm = std::move(it_prep->second.second);
+    else
+      PLApproximate(con, laPrm);
+    if (prepared_.end() != it_prep)
+      prepared_.erase(it_prep);
     if (!laPrm.fUsePeriod) {
       GetMC().NarrowVarBounds(x,
                               laPrm.grDomOut.lbx, laPrm.grDomOut.ubx);
@@ -88,9 +92,86 @@ public:
   }
 
 
+  /// Precompute the approximations of a batch of items
+  /// on several threads.
+  /// Convert() takes a precomputed approximation only if
+  /// its input (bounds, tolerance) is still the same,
+  /// so the resulting model does not depend on the threading.
+  void PrepareConversions(
+      const std::vector< std::pair<int, const ItemType*> >& items) {
+    std::size_t num_threads = GetMC().PLApproxThreads() > 0 ?
+          GetMC().PLApproxThreads() : std::thread::hardware_concurrency();
+    num_threads = std::min(num_threads,
+                           items.size() / MIN_ITEMS_PER_THREAD);
+    if (num_threads < 2)
+      return;
+    std::vector<PLApproxParams> input;
+    input.reserve(items.size());
+    for (const auto& item: items)          // reads the model: serially
+      input.push_back(MakeApproxParams(*item.second));
+    auto prm = input;                      // approximation changes grDom
+    std::vector<char> done(items.size(), 0);
+    auto approximate = [&items, &prm, &done](
+        std::size_t first, std::size_t last) {
+      for (auto k=first; k!=last; ++k) {
+        try {
+          PLApproximate(*items[k].second, prm[k]);
+          done[k] = 1;
+        } catch (...) {
+          // Convert() redoes it and reports the error in order
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t t=1; t<num_threads; ++t)
+      threads.push_back(std::thread(approximate,
+                                    items.size() * t / num_threads,
+                                    items.size() * (t+1) / num_threads));
+    approximate(0, items.size() / num_threads);
+    for (auto& thr: threads)
+      thr.join();
+    for (std::size_t k=0; k<items.size(); ++k)
+      if (done[k])
+        prepared_[items[k].first] = { input[k], std::move(prm[k]) };
+  }
+
+
 protected:
   /// Reuse the stored ModelConverter
   using Base::GetMC;
+
+  /// Input of the approximation from the current model
+  PLApproxParams MakeApproxParams(const ItemType& con) const {
+    auto x = con.GetArguments()[0];
+    auto y = con.GetResultVar();
+    PLApproxParams laPrm;
+    laPrm.ubErr = GetMC().PLApproxRelTol();
+    auto dm = GetMC().PLApproxDomain();
+    /// Narrow graph domain to +-dm
+    laPrm.grDom.lbx = std::max(GetMC().lb(x), -dm);
+    laPrm.grDom.ubx = std::min(GetMC().ub(x), dm);
+    laPrm.grDom.lby = std::max(GetMC().lb(y), -dm);
+    laPrm.grDom.uby = std::min(GetMC().ub(y), dm);
+    laPrm.is_x_int = GetMC().is_var_integer(x);
+    return laPrm;
+  }
+
+  /// Whether two approximations have the same input
+  static bool SameApproxInput(
+      const PLApproxParams& p1, const PLApproxParams& p2) {
+    return p1.grDom.lbx == p2.grDom.lbx && p1.grDom.ubx == p2.grDom.ubx &&
+        p1.grDom.lby == p2.grDom.lby && p1.grDom.uby == p2.grDom.uby &&
+        p1.is_x_int == p2.is_x_int && p1.ubErr == p2.ubErr;
+  }
+
+
+private:
+  /// Minimal batch size per thread
+  static constexpr std::size_t MIN_ITEMS_PER_THREAD = 64;
+
+  /// Precomputed approximations (input, result) by item index
+  std::unordered_map<int,
+    std::pair<PLApproxParams, PLApproxParams> > prepared_;
 };
 
 
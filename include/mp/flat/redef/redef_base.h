@@ -1,6 +1,9 @@
 #ifndef REDEF_BASE_H
 #define REDEF_BASE_H
 
+#include <utility>
+#include <vector>
+
 #include "mp/format.h"
 
 namespace mp {
@@ -24,6 +27,16 @@ public:
     return false;
   }
 
+  /// Prepare conversion of a batch of new items.
+  /// A converter whose work on an item depends only on
+  /// the item and the current model can precompute it here
+  /// (e.g., in parallel) and reuse the results in Convert().
+  /// Default: nothing.
+  /// @param items: pairs (item index, item)
+  template <class ItemType>
+  void PrepareConversions(
+      const std::vector< std::pair<int, const ItemType*> >& ) { }
+
   /// Access const ModelConverter
   const ModelConverter& GetMC() const { return mdl_cvt_; }
   /// Access ModelConverter
@@ -113,6 +126,10 @@ public:
   void Convert(const typename \
       item_cvt_type<Impl>::ItemType& con, int i) { \
     item_cvt__ ## item_cvt_type ## _ . Convert(con, i); \
+  } \
+  void PrepareCvt_impl(const std::vector< std::pair<int, \
+      const typename item_cvt_type<Impl>::ItemType*> >& items) { \
+    item_cvt__ ## item_cvt_type ## _ . PrepareConversions(items); \
   }
 
 
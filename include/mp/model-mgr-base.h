@@ -36,6 +36,13 @@ public:
                            const std::string& filename_no_ext,
                            Checker_AMPLS_ModeltTraits ) = 0;
 
+  /// Read a further NL model replacing the current one
+  /// and update the converted model in place.
+  /// @return false if not possible: then the new model
+  ///   should be read and converted by a new Model Manager
+  virtual bool UpdateNLModel(const std::string& nl_filename,
+                             const std::string& filename_no_ext) = 0;
+
   /// User-provided primal solution
   virtual ArrayRef<double> InitialValues() = 0;
   /// User-provided dual solution
@@ -91,10 +91,17 @@ protected:
     ReadNLFile(nl_filename);
 
     double read_time = GetTimeAndReset(start);
-    if (GetEnv().timing())
+    if (auto* prs = GetEnv().GetRunStats())
+      prs->AddTime("phases", "NL read", read_time);
+    if (GetEnv().timing()) {
       GetEnv().Print("NL model read time = {:.6f}s\n", read_time);
+      GetEnv().Print("NL file {} time = {:.6f}s\n",
+                     nl_read_result_.mapped_ ? "mmap" : "copy",
+                     nl_read_result_.load_time_);
+    }
 
     MakeProperSolutionHandler(filename_no_ext);
+    GetCvt().SetInputFile(nl_filename);
     ConvertModelAndUpdateBackend();
 
     if (cb_checkmodel) {
@@ -104,15 +111,47 @@ protected:
     }
 
     double cvt_time = GetTimeAndReset(start);
+    if (auto* prs = GetEnv().GetRunStats())
+      prs->AddTime("phases", "conversion", cvt_time);
     if (GetEnv().timing())
       GetEnv().Print("NL model conversion time = {:.6f}s\n", cvt_time);
   }
 
+  bool UpdateNLModel(const std::string& nl_filename,
+                     const std::string& filename_no_ext) override {
+    steady_clock::time_point start = steady_clock::now();
+
+    /// The NL handler refers to the new model,
+    /// so we keep it until the next update
+    p_update_pb_.reset(new ProblemBuilder());
+    ReadNLFile(nl_filename, *p_update_pb_);
+    if (!GetCvt().UpdateModel(*p_update_pb_))
+      return false;
+
+    MakeProperSolutionHandler(filename_no_ext);
+    double upd_time = GetTimeAndReset(start);
+    if (auto* prs = GetEnv().GetRunStats())
+      prs->AddTime("phases", "NL update", upd_time);
+    if (GetEnv().timing())
+      GetEnv().Print("NL model update time = {:.6f}s\n", upd_time);
+    return true;
+  }
+
   void ReadNLFile(const std::string& nl_filename) {
+    ReadNLFile(nl_filename, GetPB());
+  }
+
+  void ReadNLFile(const std::string& nl_filename, ProblemBuilder& pb) {
     set_nl_read_result_handler(
-          new SolverNLHandlerType(GetPB(), GetEnv()));
+          new SolverNLHandlerType(pb, GetEnv()));
     internal::NLFileReader<> reader;
-    reader.Read(nl_filename, *nl_read_result_.handler_, 0);
+    reader.set_mode(options_.nl_mmap_ ?
+                      internal::NLFileReader<>::READ_MMAP :
+                      internal::NLFileReader<>::READ_COPY);
+    reader.Read(nl_filename, *nl_read_result_.handler_,
+                options_.nl_parallel_ ? READ_LINEAR_PARALLEL : 0);
+    nl_read_result_.mapped_ = reader.mapped();
+    nl_read_result_.load_time_ = reader.load_time();
   }
 
   /// Before reading the NL file, a generic solution handler
@@ -165,6 +204,10 @@ protected:
   struct NLReadResult {
     using HandlerType = SolverNLHandlerType;
     std::unique_ptr<HandlerType> handler_;
+    /// Whether the NL file was memory-mapped rather than copied
+    bool mapped_ = false;
+    /// Time to map or copy the NL file
+    double load_time_ = 0.0;
   };
 
   void set_nl_read_result_handler(typename NLReadResult::HandlerType* ph)
@@ -233,12 +276,29 @@ protected:
 
 private:
   void InitOwnOptions() {
+    GetEnv().AddOption("tech:nlmmap nlmmap",
+        "0/1*: Whether to memory-map the NL file when possible (1), "
+        "vs. copying it into a buffer before parsing (0). "
+        "With tech:timing, the time of either method is reported.",
+        options_.nl_mmap_, 0, 1);
+    GetEnv().AddOption("tech:nlparallel nlparallel",
+        "0*/1: Whether to decode linear parts of objectives and "
+        "constraints in the NL file on multiple threads.",
+        options_.nl_parallel_, 0, 1);
   }
 
 
 private:
+  struct Options {
+    int nl_mmap_ = 1;
+    int nl_parallel_ = 0;
+  };
+  Options options_;
+
   std::unique_ptr<Converter> pcvt_;
   NLReadResult nl_read_result_;
+  /// Model read by the last UpdateNLModel()
+  std::unique_ptr<ProblemBuilder> p_update_pb_;
   std::unique_ptr<SolutionHandler> p_sol_handler_;
 };
 
@@ -40,6 +40,7 @@
 #ifndef MP_NL_READER_H_
 #define MP_NL_READER_H_
 
+#include "mp/clock.h"
 #include "mp/common.h"
 #include "mp/error.h"
 #include "mp/nl.h"
@@ -48,8 +49,13 @@
 #include <algorithm>
 #include <cctype>
 #include <cstdlib>
+#include <exception>
 #include <limits>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace mp {
 
@@ -1049,7 +1055,31 @@ struct Locale {
 };
 #endif
 
-template <typename Locale = Locale>
+/// Converts a decimal number in the "C" locale format at *str*
+/// to the nearest double using the Eisel-Lemire algorithm
+/// and advances *str* past the parsed input.
+/// Returns false leaving *str* unchanged if the number is not
+/// handled by the fast path (special values, hexadecimal,
+/// more than 19 significant digits, subnormal or out-of-range
+/// results): the caller should then use strtod.
+bool ParseDouble(const char *&str, double &value);
+
+/// A locale with a fast exact path for parsing doubles:
+/// ParseDouble(), falling back to the "C" locale's strtod.
+class FastLocale : public Locale {
+ public:
+  double strtod(const char *&str) const {
+    double value;
+    if (ParseDouble(str, value))
+      return value;
+    return Locale::strtod(str);
+  }
+};
+
+/// Text .nl reader.
+/// Locale: provides ``double strtod(const char *&str) const``,
+/// e.g., Locale (the "C" locale) or FastLocale.
+template <typename Locale = FastLocale>
 class TextReader : public ReaderBase {
  private:
   const char *line_start_;
@@ -1190,6 +1220,29 @@ class TextReader : public ReaderBase {
   /// Reads a function or suffix name.
   fmt::StringRef ReadName();
 
+  /// Reader position, including line information for error reporting.
+  struct Position {
+    const char *ptr;
+    const char *line_start;
+    int line;
+  };
+
+  Position position() const {
+    Position pos = {ptr_, line_start_, line_};
+    return pos;
+  }
+  void set_position(const Position &pos) {
+    token_ = ptr_ = pos.ptr;
+    line_start_ = pos.line_start;
+    line_ = pos.line;
+  }
+
+  /// Skips the terms of a linear expression, one per line.
+  void SkipLinearTerms(int num_terms) {
+    for (int i = 0; i < num_terms; ++i)
+      ReadTillEndOfLine();
+  }
+
   /// Reads an .nl file header. The header is always in text format, so this
   /// function doesn't have a counterpart in BinaryReader.
   void ReadHeader(NLHeader &header);
@@ -1276,6 +1329,29 @@ class BinaryReader : private InputConverter, public BinaryReaderBase {
 
   /// Reads a function or suffix name.
   fmt::StringRef ReadName() { return ReadString(); }
+
+  /// Reader position.
+  struct Position {
+    const char *ptr;
+  };
+
+  Position position() const {
+    Position pos = {ptr_};
+    return pos;
+  }
+  void set_position(const Position &pos) { set_ptr(pos.ptr); }
+
+  /// Skips the terms of a linear expression,
+  /// each an int variable index and a double coefficient.
+  void SkipLinearTerms(int num_terms) {
+    std::size_t size =
+        static_cast<std::size_t>(num_terms) * (sizeof(int) + sizeof(double));
+    if (static_cast<std::size_t>(end_ - ptr_) < size) {
+      token_ = end_;
+      ReportError("unexpected end of file");
+    }
+    ptr_ += size;
+  }
 };
 
 /// An NLHandler that forwards notification of variable bounds to another
@@ -1298,6 +1374,42 @@ struct NullLinearExprHandler {
   void AddTerm(int, double) {}
 };
 
+/// Checks if Handler accepts the linear parts of consecutive algebraic
+/// constraints in bulk via
+///
+///   void OnLinearConBlock(int first_con, int num_cons, const int *starts,
+///                         const int *vars, const double *coefs);
+///
+/// The terms of constraint first_con + i are at positions
+/// [starts[i], starts[i + 1]) of vars and coefs, starts[0] == 0.
+/// Such handlers receive OnLinearConBlock instead of OnLinearConExpr
+/// and per-term calls; the arrays are only valid during the call.
+template <typename Handler>
+class HasLinearConBlock {
+ private:
+  template <typename U>
+  static fmt::internal::Yes &test(decltype(std::declval<U&>().OnLinearConBlock(
+      0, 0, static_cast<const int*>(0), static_cast<const int*>(0),
+      static_cast<const double*>(0))) *);
+  template <typename U> static fmt::internal::No &test(...);
+ public:
+  enum {value = sizeof(test<Handler>(0)) == sizeof(fmt::internal::Yes)};
+};
+
+/// Checks if ProblemBuilder can store blocks of linear constraint
+/// expressions given in CSR form via SetLinearConExprs.
+template <typename ProblemBuilder>
+class HasSetLinearConExprs {
+ private:
+  template <typename U>
+  static fmt::internal::Yes &test(decltype(std::declval<U&>().SetLinearConExprs(
+      0, 0, static_cast<const int*>(0), static_cast<const int*>(0),
+      static_cast<const double*>(0))) *);
+  template <typename U> static fmt::internal::No &test(...);
+ public:
+  enum {value = sizeof(test<ProblemBuilder>(0)) == sizeof(fmt::internal::Yes)};
+};
+
 
 /// An NL reader.
 /// Handler: a class implementing the NLHandler concept that receives
@@ -1311,6 +1423,36 @@ class NLReader {
   int flags_;
   int num_vars_and_exprs_;  // Number of variables and common expressions.
 
+  /// A deferred G or J segment. Its terms are decoded into
+  /// linear_vars_ and linear_coefs_ starting at offset.
+  struct LinearSegment {
+    bool is_obj;
+    int index;
+    int num_terms;
+    std::size_t offset;
+    typename Reader::Position terms_start;
+
+    LinearSegment(bool obj, int i, int n, std::size_t off,
+                  typename Reader::Position pos)
+      : is_obj(obj), index(i), num_terms(n), offset(off), terms_start(pos) {}
+  };
+
+  enum {
+    /// Pending terms after which linear segments are decoded,
+    /// to bound the buffer size.
+    MAX_PENDING_TERMS = 1 << 23,
+    /// Minimal number of terms per decoding thread.
+    MIN_TERMS_PER_THREAD = 1 << 16
+  };
+
+  std::vector<LinearSegment> linear_segments_;
+  std::size_t num_pending_terms_;
+
+  // Decoded terms of the deferred segments.
+  std::vector<int> linear_vars_;
+  std::vector<double> linear_coefs_;
+  std::vector<int> block_starts_;
+
   typedef typename Handler::Expr Expr;
   typedef typename Handler::NumericExpr NumericExpr;
   typedef typename Handler::LogicalExpr LogicalExpr;
@@ -1501,6 +1643,42 @@ class NLReader {
   template <typename LinearHandler>
   void ReadLinearExpr(int num_terms, LinearHandler linear_expr);
 
+  /// Reads the header of a G or J segment and skips its terms
+  /// which are decoded later by ReadLinearSegments().
+  template <typename LinearHandler>
+  void DeferLinearExpr();
+
+  /// Decodes the terms of the deferred G and J segments in parallel
+  /// and passes them to the handler in the input order.
+  void ReadLinearSegments();
+
+  /// Decodes segments [begin, end), stops at the first error.
+  void DecodeLinearSegments(std::size_t begin, std::size_t end,
+                            std::exception_ptr &error);
+
+  template <typename LinearHandler>
+  void AddTerms(const LinearSegment &seg, LinearHandler linear_expr) {
+    const int *vars = &linear_vars_[seg.offset];
+    const double *coefs = &linear_coefs_[seg.offset];
+    for (int i = 0; i < seg.num_terms; ++i)
+      linear_expr.AddTerm(vars[i], coefs[i]);
+  }
+
+  /// Passes the J segments [begin, end) to the handler.
+  /// Returns the index of the next undelivered segment.
+  std::size_t AddLinearCons(std::size_t begin, std::size_t,
+                            std::false_type) {
+    const LinearSegment &seg = linear_segments_[begin];
+    AddTerms(seg, AlgebraicConHandler(*this).OnLinearExpr(
+               seg.index, seg.num_terms));
+    return begin + 1;
+  }
+
+  // Passes the longest run of J segments for consecutive constraints
+  // starting at begin as a single block.
+  std::size_t AddLinearCons(std::size_t begin, std::size_t end,
+                            std::true_type);
+
   /// Reads column sizes, numbers of nonzeros in the first num_var − 1
   /// columns of the Jacobian sparsity matrix.
   template <bool CUMULATIVE>
@@ -1534,7 +1712,7 @@ class NLReader {
  public:
   NLReader(Reader &reader, const NLHeader &header, Handler &handler, int flags)
     : reader_(reader), header_(header), handler_(handler), flags_(flags),
-      num_vars_and_exprs_(0) {}
+      num_vars_and_exprs_(0), num_pending_terms_(0) {}
 
   /// Algebraic constraint handler.
   struct AlgebraicConHandler : ItemHandler<CON> {
@@ -1808,6 +1986,118 @@ void NLReader<Reader, Handler>::ReadLinearExpr(
   }
 }
 
+template <typename Reader, typename Handler>
+template <typename LinearHandler>
+void NLReader<Reader, Handler>::DeferLinearExpr() {
+  LinearHandler lh(*this);
+  int index = ReadUInt(lh.num_items());
+  int num_terms = ReadUInt(1, header_.num_vars + 1u);
+  reader_.ReadTillEndOfLine();
+  linear_segments_.push_back(LinearSegment(
+      LinearHandler::TYPE == OBJ, index, num_terms, num_pending_terms_,
+      reader_.position()));
+  reader_.SkipLinearTerms(num_terms);
+  num_pending_terms_ += num_terms;
+  if (num_pending_terms_ >= static_cast<std::size_t>(MAX_PENDING_TERMS))
+    ReadLinearSegments();
+}
+
+template <typename Reader, typename Handler>
+void NLReader<Reader, Handler>::DecodeLinearSegments(
+    std::size_t begin, std::size_t end, std::exception_ptr &error) {
+  try {
+    Reader reader(reader_);
+    for (; begin != end; ++begin) {
+      const LinearSegment &seg = linear_segments_[begin];
+      reader.set_position(seg.terms_start);
+      int *vars = &linear_vars_[seg.offset];
+      double *coefs = &linear_coefs_[seg.offset];
+      for (int i = 0; i < seg.num_terms; ++i) {
+        int var_index = reader.ReadUInt();
+        if (static_cast<unsigned>(var_index) >=
+            static_cast<unsigned>(header_.num_vars))
+          reader.ReportError("integer {} out of bounds", var_index);
+        vars[i] = var_index;
+        coefs[i] = reader.ReadDouble();
+        reader.ReadTillEndOfLine();
+      }
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+}
+
+template <typename Reader, typename Handler>
+void NLReader<Reader, Handler>::ReadLinearSegments() {
+  std::size_t num_segments = linear_segments_.size();
+  std::size_t num_threads = (flags_ & READ_LINEAR_PARALLEL) != 0 ?
+        std::thread::hardware_concurrency() : 1;
+  num_threads = std::min<std::size_t>(
+        std::max<std::size_t>(num_threads, 1),
+        num_pending_terms_ / MIN_TERMS_PER_THREAD + 1);
+  // Split into chunks of about the same number of terms.
+  std::vector<std::size_t> chunk_starts(1, 0);
+  std::size_t num_terms = 0;
+  for (std::size_t i = 0; i < num_segments; ++i) {
+    num_terms += linear_segments_[i].num_terms;
+    if (num_terms * num_threads >= num_pending_terms_ * chunk_starts.size() &&
+        chunk_starts.size() < num_threads)
+      chunk_starts.push_back(i + 1);
+  }
+  chunk_starts.push_back(num_segments);
+  std::size_t num_chunks = chunk_starts.size() - 1;
+  linear_vars_.resize(num_pending_terms_);
+  linear_coefs_.resize(num_pending_terms_);
+  std::vector<std::exception_ptr> errors(num_chunks);
+  std::vector<std::thread> threads;
+  for (std::size_t c = 1; c < num_chunks; ++c) {
+    threads.push_back(std::thread(
+        &NLReader::DecodeLinearSegments, this,
+        chunk_starts[c], chunk_starts[c + 1], std::ref(errors[c])));
+  }
+  DecodeLinearSegments(chunk_starts[0], chunk_starts[1], errors[0]);
+  for (std::size_t t = 0; t < threads.size(); ++t)
+    threads[t].join();
+  // Report the first error in input order.
+  for (std::size_t c = 0; c < num_chunks; ++c) {
+    if (errors[c])
+      std::rethrow_exception(errors[c]);
+  }
+  for (std::size_t i = 0; i < num_segments; ) {
+    const LinearSegment &seg = linear_segments_[i];
+    if (!seg.is_obj) {
+      i = AddLinearCons(i, num_segments, std::integral_constant<
+                          bool, HasLinearConBlock<Handler>::value>());
+      continue;
+    }
+    ObjHandler lh(*this);
+    if (!lh.SkipExpr(seg.index))
+      AddTerms(seg, lh.OnLinearExpr(seg.index, seg.num_terms));
+    ++i;
+  }
+  linear_segments_.clear();
+  num_pending_terms_ = 0;
+}
+
+template <typename Reader, typename Handler>
+std::size_t NLReader<Reader, Handler>::AddLinearCons(
+    std::size_t begin, std::size_t end, std::true_type) {
+  const LinearSegment &first = linear_segments_[begin];
+  block_starts_.assign(1, 0);
+  std::size_t i = begin;
+  for (int index = first.index; i != end; ++i, ++index) {
+    const LinearSegment &seg = linear_segments_[i];
+    if (seg.is_obj || seg.index != index)
+      break;
+    block_starts_.push_back(block_starts_.back() + seg.num_terms);
+  }
+  handler_.OnLinearConBlock(
+        first.index, static_cast<int>(i - begin), block_starts_.data(),
+        linear_vars_.data() + first.offset,
+        linear_coefs_.data() + first.offset);
+  return i;
+}
+
 template <typename Reader, typename Handler>
 template <typename BoundHandler>
 void NLReader<Reader, Handler>::ReadBounds() {
@@ -1934,8 +2224,14 @@ void NLReader<Reader, Handler>::Read(Reader *bound_reader) {
       header_.num_common_exprs_in_objs +
       header_.num_common_exprs_in_single_cons +
       header_.num_common_exprs_in_single_objs;
+  // Linear segments are deferred to decode them in parallel or to pass
+  // constraint blocks to the handler.
+  bool defer_linear = (flags_ & READ_LINEAR_PARALLEL) != 0 ||
+      HasLinearConBlock<Handler>::value;
   for (;;) {
     char c = reader_.ReadChar();
+    if (!linear_segments_.empty() && c != 'G' && c != 'J')
+      ReadLinearSegments();
     switch (c) {
     case 'C': {
       // Nonlinear part of an algebraic constraint body.
@@ -1992,11 +2288,17 @@ void NLReader<Reader, Handler>::Read(Reader *bound_reader) {
     }
     case 'G':
       // Linear part of an objective expression & gradient sparsity.
-      ReadLinearExpr<ObjHandler>();
+      if (defer_linear)
+        DeferLinearExpr<ObjHandler>();
+      else
+        ReadLinearExpr<ObjHandler>();
       break;
     case 'J':
       // Jacobian sparsity & linear terms in constraints.
-      ReadLinearExpr<AlgebraicConHandler>();
+      if (defer_linear)
+        DeferLinearExpr<AlgebraicConHandler>();
+      else
+        ReadLinearExpr<AlgebraicConHandler>();
       break;
     case 'S': {
       // Suffix values.
@@ -2090,34 +2392,78 @@ void NLReader<Reader, Handler>::Read() {
 /// An .nl file reader.
 template <typename File = fmt::File>
 class NLFileReader {
+ public:
+  /// How the file contents are made available to the parser.
+  enum ReadMode {
+    /// Map the file into memory if the page-rounded mapping
+    /// is zero-terminated, otherwise copy it into a buffer.
+    READ_MMAP,
+    /// Always copy the file into a buffer.
+    READ_COPY
+  };
+
  private:
   File file_;
   std::size_t size_;
   std::size_t rounded_size_;  // Size rounded up to a multiple of page size.
+  ReadMode mode_;
+  bool mapped_;               // Whether the last read used mmap.
+  double load_time_;          // Time to map or copy the file, seconds.
 
   void Open(fmt::CStringRef filename);
 
   /// Reads the file into an array.
   void Read(fmt::internal::MemoryBuffer<char, 1> &array);
 
+  /// Maps the file into memory.
+  /// Returns false if the system cannot map it.
+  bool Map(MemoryMappedFile<File> &mapped_file) {
+    try {
+      mapped_file.map(file_, rounded_size_);
+    } catch (const fmt::SystemError &) {
+      return false;
+    }
+    return true;
+  }
+
  public:
-  NLFileReader() : size_(0), rounded_size_(0) {}
+  NLFileReader()
+    : size_(0), rounded_size_(0), mode_(READ_MMAP),
+      mapped_(false), load_time_(0) {}
 
   const File &file() { return file_; }
 
+  /// Read mode.
+  ReadMode mode() const { return mode_; }
+  /// Set read mode.
+  void set_mode(ReadMode mode) { mode_ = mode; }
+
+  /// Whether the last Read() has mapped the file
+  /// rather than copied it.
+  bool mapped() const { return mapped_; }
+
+  /// Wall time in seconds the last Read() spent making the file
+  /// contents available (mapping or copying), excluding parsing.
+  double load_time() const { return load_time_; }
+
   /// Opens and reads the file.
   template <typename Handler>
   void Read(fmt::CStringRef filename, Handler &handler, int flags) {
     Open(filename);
-    if (size_ == rounded_size_) {
-      // Don't use mmap, because the file size is a multiple of the page size
-      // and therefore the mmap'ed buffer won't be null-terminated.
+    steady_clock::time_point start = steady_clock::now();
+    MemoryMappedFile<File> mapped_file;
+    // Don't use mmap if the file size is a multiple of the page size,
+    // because then the mmap'ed buffer won't be null-terminated.
+    mapped_ = mode_ == READ_MMAP && size_ != rounded_size_ &&
+        Map(mapped_file);
+    if (!mapped_) {
       fmt::internal::MemoryBuffer<char, 1> array;
       Read(array);
+      load_time_ = GetTimeAndReset(start);
       return ReadNLString(
             NLStringRef(&array[0], size_), handler, filename, flags);
     }
-    MemoryMappedFile<File> mapped_file(file_, rounded_size_);
+    load_time_ = GetTimeAndReset(start);
     ReadNLString(
           NLStringRef(mapped_file.start(), size_), handler, filename, flags);
   }
@@ -2340,6 +2686,35 @@ class NLProblemBuilder {
     return builder_.algebraic_con(con_index).set_linear_expr(num_linear_terms);
   }
 
+  /// Receives the linear parts of constraints
+  /// [first_con, first_con + num_cons) in CSR form.
+  void OnLinearConBlock(int first_con, int num_cons, const int *starts,
+                        const int *vars, const double *coefs) {
+    SetLinearConExprs(first_con, num_cons, starts, vars, coefs,
+                      std::integral_constant<
+                        bool, HasSetLinearConExprs<ProblemBuilder>::value>());
+  }
+
+ private:
+  void SetLinearConExprs(int first_con, int num_cons, const int *starts,
+                         const int *vars, const double *coefs,
+                         std::true_type) {
+    builder_.SetLinearConExprs(first_con, num_cons, starts, vars, coefs);
+  }
+
+  void SetLinearConExprs(int first_con, int num_cons, const int *starts,
+                         const int *vars, const double *coefs,
+                         std::false_type) {
+    for (int i = 0; i < num_cons; ++i) {
+      int start = starts[i], end = starts[i + 1];
+      LinearConHandler con = builder_.algebraic_con(first_con + i).
+          set_linear_expr(end - start);
+      for (int k = start; k < end; ++k)
+        con.AddTerm(vars[k], coefs[k]);
+    }
+  }
+
+ public:
   typedef typename ProblemBuilder::LinearExprBuilder LinearExprHandler;
 
   LinearExprHandler BeginCommonExpr(int index, int num_linear_terms) {
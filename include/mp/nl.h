@@ -68,7 +68,13 @@ class NLStringRef {
 /// Flags for ReadNLFile and ReadNLString.
 enum {
   /** Read variable bounds before anything else. */
-  READ_BOUNDS_FIRST = 1
+  READ_BOUNDS_FIRST = 1,
+  /**
+    Decode the terms of consecutive linear objective and constraint
+    segments (G, J) in parallel. The handler receives them in the
+    input order, from the calling thread.
+   */
+  READ_LINEAR_PARALLEL = 2
 };
 
 /**
@@ -96,9 +102,11 @@ void ReadNLString(NLStringRef str, Handler &handler,
 
   The *filename* argument can be a C string or an ``std::string`` object.
   *flags* can be either 0, which is the default, to read all constructs in
-  the order they appear in the input, or `mp::READ_BOUNDS_FIRST` to read
-  variable bounds after the NL header and before other constructs such as
-  nonlinear expressions.
+  the order they appear in the input, or a combination of
+  `mp::READ_BOUNDS_FIRST` to read variable bounds after the NL header
+  and before other constructs such as nonlinear expressions, and
+  `mp::READ_LINEAR_PARALLEL` to decode linear parts of objectives and
+  constraints on multiple threads.
 
   **Example**::
 
@@ -507,6 +507,15 @@ class ColProblemBuilder : public internal::NLProblemBuilder<ColProblem> {
     Base::OnLinearConExpr(con_index, 0);
     return LinearConHandler(builder(), con_index);
   }
+
+  void OnLinearConBlock(int first_con, int num_cons, const int *starts,
+                        const int *vars, const double *coefs) {
+    for (int i = 0; i < num_cons; ++i) {
+      LinearConHandler con = OnLinearConExpr(first_con + i, 0);
+      for (int k = starts[i], end = starts[i + 1]; k < end; ++k)
+        con.AddTerm(vars[k], coefs[k]);
+    }
+  }
 };
 }  // namespace mp
 
@@ -23,7 +23,13 @@
 #ifndef MP_PROBLEM_H_
 #define MP_PROBLEM_H_
 
+#include <algorithm>
+#include <array>
 #include <cstddef>  // for std::size_t
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iterator>
 #include <limits>
 #include <cmath>
 #include <vector>
@@ -40,61 +46,197 @@
 namespace mp {
 
 /// Linear expression (not affine: no constant term)
-/// used in `mp::BasicProblem<>`
+/// used in `mp::BasicProblem<>`.
+/// Terms are stored as separate arrays of variable indices and
+/// coefficients. An expression either owns them or is a view of
+/// terms stored elsewhere, e.g. in a problem's block of constraint
+/// terms. A view is copied into own storage on the first modification.
 class LinearExpr {
- private:
+ public:
   class Term {
    private:
     int var_index_;
     double coef_;
 
-    friend class LinearExpr;
-
+   public:
+    Term() : var_index_(0), coef_(0) {}
     Term(int var_index, double coef) : var_index_(var_index), coef_(coef) {}
 
-   public:
     int var_index() const { return var_index_; }
     double coef() const { return coef_; }
     void set_coef(double c) { coef_=c; }
     void operator*=(double n) { coef_*=n; }
   };
-  std::vector<Term> terms_;
+
+  /// Term iterator. Dereferencing gives a Term by value.
+  class const_iterator {
+   private:
+    const LinearExpr *expr_;
+    int index_;
+    mutable Term term_;
+
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Term value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Term *pointer;
+    typedef Term reference;
+
+    const_iterator(const LinearExpr *e = 0, int index = 0)
+      : expr_(e), index_(index) {}
+
+    Term operator*() const {
+      return Term(expr_->vars_[index_], expr_->coefs_[index_]);
+    }
+
+    const Term *operator->() const {
+      term_ = **this;
+      return &term_;
+    }
+
+    const_iterator &operator++() {
+      ++index_;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator it(*this);
+      ++index_;
+      return it;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return expr_ == other.expr_ && index_ == other.index_;
+    }
+    bool operator!=(const const_iterator &other) const {
+      return !(*this == other);
+    }
+  };
+
+  /// Terms are modified via set_coef() rather than iterators.
+  typedef const_iterator iterator;
+
+ private:
+  int *vars_;
+  double *coefs_;
+  int num_terms_;
+  int capacity_;  // -1 for a view
+
+  // Reallocates own storage for the specified number of terms.
+  void Reallocate(int capacity);
+
+  void MakeOwned() {
+    if (capacity_ < 0)
+      Reallocate(num_terms_);
+  }
+
+  void Free() {
+    if (capacity_ > 0)
+      std::free(coefs_);
+  }
+
+  void MoveFrom(LinearExpr &other) {
+    vars_ = other.vars_;
+    coefs_ = other.coefs_;
+    num_terms_ = other.num_terms_;
+    capacity_ = other.capacity_;
+    other.vars_ = 0;
+    other.coefs_ = 0;
+    other.num_terms_ = other.capacity_ = 0;
+  }
+
+  void CopyFrom(const LinearExpr &other) {
+    vars_ = other.vars_;
+    coefs_ = other.coefs_;
+    num_terms_ = other.num_terms_;
+    capacity_ = other.capacity_;
+    if (capacity_ > 0) {
+      capacity_ = 0;  // Don't free other's terms.
+      Reallocate(other.capacity_);
+    }
+  }
 
  public:
-  LinearExpr() { }
+  LinearExpr() : vars_(0), coefs_(0), num_terms_(0), capacity_(0) { }
 
   template <class CoefVec=std::vector<double>, class VarVec=std::vector<int> >
-  LinearExpr(CoefVec&& c, VarVec&& v) {
+  LinearExpr(CoefVec&& c, VarVec&& v)
+    : vars_(0), coefs_(0), num_terms_(0), capacity_(0) {
     ConstructFrom(std::forward<CoefVec>(c), std::forward<VarVec>(v));
   }
   template <int N>
-  LinearExpr(const std::array<double, N>& c, const std::array<int, N>& v) {
+  LinearExpr(const std::array<double, N>& c, const std::array<int, N>& v)
+    : vars_(0), coefs_(0), num_terms_(0), capacity_(0) {
     ConstructFrom(c, v);
   }
 
-  int num_terms() const { return static_cast<int>(terms_.size()); }
-  int capacity() const { return static_cast<int>(terms_.capacity()); }
+  /// Copies a view as a view and owned terms as owned terms.
+  LinearExpr(const LinearExpr &other) { CopyFrom(other); }
+
+  LinearExpr(LinearExpr &&other) noexcept { MoveFrom(other); }
+
+  ~LinearExpr() { Free(); }
+
+  LinearExpr &operator=(const LinearExpr &other) {
+    if (this != &other) {
+      Free();
+      CopyFrom(other);
+    }
+    return *this;
+  }
+
+  LinearExpr &operator=(LinearExpr &&other) noexcept {
+    if (this != &other) {
+      Free();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  /// Returns a view of num_terms terms stored in vars and coefs
+  /// which should outlive it.
+  static LinearExpr View(const int *vars, const double *coefs,
+                         int num_terms) {
+    LinearExpr e;
+    e.vars_ = const_cast<int*>(vars);
+    e.coefs_ = const_cast<double*>(coefs);
+    e.num_terms_ = num_terms;
+    e.capacity_ = -1;
+    return e;
+  }
 
-  int var_index(int i) const { return terms_[i].var_index(); }
-  double coef(int i) const { return terms_[i].coef(); }
-  void set_coef(int i, double c) { terms_[i].set_coef(c); }
+  /// Returns true if the expression is a view of external terms.
+  bool is_view() const { return capacity_ < 0; }
 
-  typedef std::vector<Term>::const_iterator const_iterator;
+  int num_terms() const { return num_terms_; }
+  int capacity() const { return capacity_ < 0 ? num_terms_ : capacity_; }
 
-  const_iterator begin() const { return terms_.begin(); }
-  const_iterator end() const { return terms_.end(); }
+  int var_index(int i) const { return vars_[i]; }
+  double coef(int i) const { return coefs_[i]; }
+  void set_coef(int i, double c) {
+    MakeOwned();
+    coefs_[i] = c;
+  }
 
-  typedef std::vector<Term>::iterator iterator;
+  /// Returns the variable indices and coefficients of the terms.
+  const int *vars() const { return vars_; }
+  const double *coefs() const { return coefs_; }
 
-  iterator begin() { return terms_.begin(); }
-  iterator end() { return terms_.end(); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, num_terms_); }
 
   void AddTerm(int var_index, double coef) {
-    terms_.push_back(Term(var_index, coef));
+    if (num_terms_ >= capacity_)
+      Reallocate(num_terms_ != 0 ? 2 * num_terms_ : 1);
+    vars_[num_terms_] = var_index;
+    coefs_[num_terms_] = coef;
+    ++num_terms_;
   }
 
   void AddTerms(const LinearExpr& li) {
-    terms_.insert(end(), li.begin(), li.end());
+    Reserve(num_terms_ + li.num_terms());
+    for (int i = 0, n = li.num_terms(); i < n; ++i)
+      AddTerm(li.var_index(i), li.coef(i));
   }
 
   template <class CoefVec=std::vector<double>, class VarVec=std::vector<int> >
@@ -107,21 +249,44 @@ class LinearExpr {
   }
 
   void Reserve(std::size_t num_terms) {
-    terms_.reserve(num_terms);
+    if (capacity_ < 0 || static_cast<int>(num_terms) > capacity_) {
+      Reallocate(std::max(static_cast<int>(num_terms), num_terms_));
+    }
   }
 
   void SortTerms();
 };
 
-/// Placeholder for whatever params of BasicProblem<>
-template < class A = int >
+/// Differences of a problem from another one,
+/// see BasicProblem::Compare()
+struct ProblemDiff {
+  /// Whether the problems are linear and differ at most
+  /// in the items listed below
+  bool same_structure = false;
+  /// Variables with different bounds
+  std::vector<int> vars;
+  /// Algebraic constraints with different bounds
+  std::vector<int> alg_cons;
+  /// Objectives with different linear coefficients
+  std::vector<int> objs;
+
+  /// Whether there are no differences at all
+  bool empty() const
+  { return vars.empty() && alg_cons.empty() && objs.empty(); }
+};
+
+/// Params of BasicProblem<>
+/// A: allocator of expressions, e.g. ArenaAllocator
+template < class A = std::allocator<char> >
 struct BasicProblemParams {
   using Alloc = A;
 };
 
 /// An optimization problem
 template <typename ProblemParams = BasicProblemParams<> >
-class BasicProblem : public ExprFactory, public SuffixManager {
+class BasicProblem :
+    public BasicExprFactory<typename ProblemParams::Alloc>,
+    public SuffixManager {
  public:
   typedef mp::Function Function;
   typedef mp::Expr Expr;
@@ -172,6 +337,14 @@ class BasicProblem : public ExprFactory, public SuffixManager {
   };
   std::vector<AlgebraicConInfo> algebraic_cons_;
 
+  /// Terms of constraints set with SetLinearConExprs in CSR blocks.
+  /// Linear parts of such constraints are views of these blocks.
+  struct LinearBlock {
+    std::vector<int> vars;
+    std::vector<double> coefs;
+  };
+  std::deque<LinearBlock> linear_blocks_;
+
   /// Nonlinear parts of algebraic constraint expressions.
   /// The array can be empty if the problem is linear.
   std::vector<NumericExpr> nonlinear_cons_;
@@ -846,6 +1019,33 @@ public:
     algebraic_cons_.resize(num_cons);
   }
 
+  /// Sets the linear parts of constraints [first_con, first_con + num_cons)
+  /// given in CSR form: terms of constraint first_con + i are at positions
+  /// [starts[i], starts[i + 1]) of vars and coefs.
+  /// The terms are stored in a single block rather than per constraint.
+  void SetLinearConExprs(int first_con, int num_cons, const int *starts,
+                         const int *vars, const double *coefs) {
+    if (num_cons == 0)
+      return;
+    internal::CheckIndex(first_con, num_algebraic_cons());
+    internal::CheckIndex(first_con + num_cons - 1, num_algebraic_cons());
+    linear_blocks_.push_back(LinearBlock());
+    LinearBlock &block = linear_blocks_.back();
+    block.vars.assign(vars + starts[0], vars + starts[num_cons]);
+    block.coefs.assign(coefs + starts[0], coefs + starts[num_cons]);
+    for (int i = 0; i < num_cons; ++i) {
+      int start = starts[i] - starts[0];
+      int num_terms = starts[i + 1] - starts[i];
+      LinearExpr &expr = algebraic_cons_[first_con + i].linear_expr;
+      LinearExpr view = LinearExpr::View(
+            block.vars.data() + start, block.coefs.data() + start, num_terms);
+      if (expr.num_terms() == 0)
+        expr = std::move(view);
+      else
+        expr.AddTerms(view);
+    }
+  }
+
   /// A logical constraint.
   template <typename Item>
   class BasicLogicalCon : private Item {
@@ -1060,42 +1260,56 @@ public:
 
   int GetSuffixSize(suf::Kind kind);
 
+  /// Adds a suffix with at most \a num_nonzeros nonzero values
+  /// (negative if unknown), stored sparsely if they are few.
   template <typename T>
-  SuffixHandler<T> AddSuffix(fmt::StringRef name, int kind) {
+  SuffixHandler<T> AddSuffix(fmt::StringRef name, int kind,
+                             int num_nonzeros = -1) {
     auto main_kind = (suf::Kind)(kind & suf::KIND_MASK);
     return SuffixHandler<T>(
-          suffixes(main_kind).template Add<T>(name, kind, GetSuffixSize(main_kind)));
+          suffixes(main_kind).template AddForNonzeros<T>(
+            name, kind, GetSuffixSize(main_kind), num_nonzeros));
   }
 
   typedef SuffixHandler<int> IntSuffixHandler;
 
   /// Adds an integer suffix.
   /// name: Suffix name that may not be null-terminated.
-  IntSuffixHandler AddIntSuffix(fmt::StringRef name, int kind, int=0) {
-    return AddSuffix<int>(name, kind);
+  /// num_values: number of values to be set, as in the NL file.
+  IntSuffixHandler AddIntSuffix(fmt::StringRef name, int kind,
+                                int num_values=-1) {
+    return AddSuffix<int>(name, kind, num_values);
   }
 
   typedef SuffixHandler<double> DblSuffixHandler;
 
   /// Adds a double suffix.
   /// name: Suffix name that may not be null-terminated.
-  DblSuffixHandler AddDblSuffix(fmt::StringRef name, suf::Kind kind, int) {
-    return AddSuffix<double>(name, kind);
+  /// num_values: number of values to be set, as in the NL file.
+  DblSuffixHandler AddDblSuffix(fmt::StringRef name, suf::Kind kind,
+                                int num_values) {
+    return AddSuffix<double>(name, kind, num_values);
   }
 
   ////////////////////////// HIGH-LEVEL SUFFIX I/O //////////////////////////////
+  /// Report suffix values.
+  /// The suffix is stored sparsely if few values are nonzero,
+  /// so that the .sol file output is proportional to the nonzeros.
   template <class T>
   void ReportSuffix(const SuffixDef<T>& sufdef,
                     ArrayRef<T> values) {
     if (values.empty())
       return;
-    auto suf = FindOrCreateSuffix(sufdef);
-    auto suf_size = suf.num_values();
+    auto main_kind = (suf::Kind)(sufdef.kind() & suf::KIND_MASK);
+    int suf_size = GetSuffixSize(main_kind);
     /// Check this because Converter or solver can add more variables
     assert(suf_size <= (int)values.size());
-    for (auto i=suf_size; i--; ) {
-      suf.set_value(i, values[i]);
-    }
+    int nnz = (int)std::count_if(values.begin(), values.begin() + suf_size,
+                                 [](T v) { return v != 0; });
+    auto suf = FindOrCreateSuffix(sufdef, nnz);
+    suffixes(main_kind).SetSparse(
+          suf, internal::PreferSparseSuffix(nnz, suf.num_values()));
+    suf.set_values(values);
   }
 
   template <class T>
@@ -1132,8 +1346,11 @@ public:
     return BasicMutSuffix<T>();
   }
 
+  /// Find suffix, or create it for \a num_nonzeros nonzero values
+  /// (negative if unknown)
   template <class T>
-  BasicMutSuffix<T> FindOrCreateSuffix(const SuffixDef<T>& sufdef) {
+  BasicMutSuffix<T> FindOrCreateSuffix(const SuffixDef<T>& sufdef,
+                                       int num_nonzeros = -1) {
     auto main_kind = (suf::Kind)(sufdef.kind() & suf::KIND_MASK);
     auto suf_raw = FindSuffix(sufdef);
     auto suf_size = GetSuffixSize(main_kind);    // can be < values.size()
@@ -1142,14 +1359,30 @@ public:
       return suf_raw;
     }
     return suffixes(main_kind).template
-            Add<T>(sufdef.name(), sufdef.kind() | suf::OUTPUT,
-                   suf_size, sufdef.table());
+            AddForNonzeros<T>(sufdef.name(), sufdef.kind() | suf::OUTPUT,
+                              suf_size, num_nonzeros, sufdef.table());
   }
 
   ///////////////////////////////////////////////////////////////////////
   /// Sets problem information and reserves memory for problem elements.
   void SetInfo(const ProblemInfo &info);
 
+  ////////////////////////// INCREMENTAL UPDATES ////////////////////////
+  /// Returns true if the problem has no nonlinear expressions,
+  /// logical constraints, common expressions or complementarity.
+  bool is_linear() const;
+
+  /// Compares with \a other.
+  /// The structure is the same if both problems are linear
+  /// and have the same variables' types, objectives' senses
+  /// and variables, and constraint bodies.
+  ProblemDiff Compare(const BasicProblem& other) const;
+
+  /// Takes over the items listed in \a diff from \a other,
+  /// as well as its initial values and suffixes
+  /// (exchanging them with own ones).
+  void Update(BasicProblem& other, const ProblemDiff& diff);
+
   /// Pushing the whole instance to a backend or converter.
   /// A responsible backend should handle all essential items
   template <class Backend>
@@ -0,0 +1,137 @@
+#ifndef RUNSTATS_H
+#define RUNSTATS_H
+
+/// Run statistics: timings and counters of the run phases,
+/// constraint keepers, etc.
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "mp/clock.h"
+#include "mp/format.h"
+
+namespace mp {
+
+/// Run statistics.
+///
+/// Values are grouped as group -> item -> field -> value,
+/// for example, "keepers" -> "LinConRange" -> "converted" -> 15.
+/// Written as JSON with the same nesting.
+/// Not thread-safe.
+class RunStats {
+public:
+  /// Add \a v to a value
+  void Add(const std::string& group, const std::string& item,
+           const std::string& field, double v)
+  { data_[group][item][field] += v; }
+
+  /// Set a value
+  void Set(const std::string& group, const std::string& item,
+           const std::string& field, double v)
+  { data_[group][item][field] = v; }
+
+  /// Add the time \a t of a call: fields "time" and "calls"
+  void AddTime(const std::string& group, const std::string& item,
+               double t) {
+    auto& fields = data_[group][item];
+    fields["time"] += t;
+    fields["calls"] += 1;
+  }
+
+  /// Get a value, 0 if not recorded
+  double Get(const std::string& group, const std::string& item,
+             const std::string& field) const {
+    auto itg = data_.find(group);
+    if (data_.end() == itg)
+      return 0.0;
+    auto iti = itg->second.find(item);
+    if (itg->second.end() == iti)
+      return 0.0;
+    auto itf = iti->second.find(field);
+    return iti->second.end() == itf ? 0.0 : itf->second;
+  }
+
+  /// Nothing recorded?
+  bool empty() const { return data_.empty(); }
+
+  /// Clear
+  void clear() { data_.clear(); }
+
+  /// Write as JSON
+  void WriteJSON(fmt::MemoryWriter& wrt) const {
+    wrt << '{';
+    const char* sep_g = "\n";
+    for (const auto& group: data_) {
+      wrt << sep_g << "  \"" << Escape(group.first) << "\": {";
+      const char* sep_i = "\n";
+      for (const auto& item: group.second) {
+        wrt << sep_i << "    \"" << Escape(item.first) << "\": {";
+        const char* sep_f = " ";
+        for (const auto& field: item.second) {
+          wrt.write("{}\"{}\": {}", sep_f,
+                    Escape(field.first), field.second);
+          sep_f = ", ";
+        }
+        wrt << " }";
+        sep_i = ",\n";
+      }
+      wrt << "\n  }";
+      sep_g = ",\n";
+    }
+    wrt << "\n}\n";
+  }
+
+
+protected:
+  /// Escape a string for JSON
+  static std::string Escape(const std::string& s) {
+    std::string res;
+    res.reserve(s.size());
+    for (auto c: s) {
+      if ('"'==c || '\\'==c)
+        res += '\\';
+      res += c;
+    }
+    return res;
+  }
+
+
+private:
+  using Fields = std::map<std::string, double>;
+  using Items = std::map<std::string, Fields>;
+  std::map<std::string, Items> data_;
+};
+
+
+/// Scoped timer: adds the time of its scope to RunStats,
+/// unless \a prs is null
+class ScopedRunTimer {
+public:
+  /// Construct
+  ScopedRunTimer(RunStats* prs, const char* group, std::string item) :
+    prs_(prs), group_(group), item_(std::move(item)) {
+    if (prs_)
+      start_ = steady_clock::now();
+  }
+
+  /// Destruct: record the time
+  ~ScopedRunTimer() {
+    if (prs_)
+      prs_->AddTime(group_, item_, GetTimeAndReset(start_));
+  }
+
+  ScopedRunTimer(const ScopedRunTimer& ) = delete;
+  ScopedRunTimer& operator=(const ScopedRunTimer& ) = delete;
+
+
+private:
+  RunStats* const prs_;
+  const char* const group_;
+  const std::string item_;
+  steady_clock::time_point start_;
+};
+
+} // namespace mp
+
+#endif // RUNSTATS_H
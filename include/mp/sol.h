@@ -30,6 +30,7 @@
 #include <cstdio>
 #include <cstring>
 #include <algorithm>
+#include <vector>
 
 #include "mp/common.h"
 #include "mp/posix.h"
@@ -97,6 +98,87 @@ void WriteSuffixes(fmt::BufferedFile &file, const SuffixMap *suffixes) {
     i->VisitValues(writer);
   }
 }
+
+/// Write a record of a binary .sol file:
+/// the data size in bytes as int, the data, and the size again
+void WriteBinaryRecord(fmt::BufferedFile &file, const void *data, int size);
+
+/// Write message into a binary .sol file:
+/// each line as a record, then an empty record
+void WriteBinaryMessage(fmt::BufferedFile &file, const char *message);
+
+/// Write a record of \a n doubles obtained by \a get(i).
+/// The values are written in chunks to avoid a full copy
+template <typename GetValue>
+void WriteBinaryDoubles(fmt::BufferedFile &file, int n, GetValue get) {
+  int size = n * static_cast<int>(sizeof(double));
+  std::fwrite(&size, sizeof(size), 1, file.get());
+  double buf[1024];
+  for (int i = 0; i < n; ) {
+    int k = 0;
+    for ( ; k < 1024 && i < n; ++k, ++i)
+      buf[k] = get(i);
+    std::fwrite(buf, sizeof(double), k, file.get());
+  }
+  std::fwrite(&size, sizeof(size), 1, file.get());
+}
+
+/// Suffix value visitor that stores index/value pairs
+/// for a binary .sol file
+class SuffixValueBinaryWriter {
+ private:
+  std::vector<char> data_;
+
+  void Append(const void *p, std::size_t n) {
+    const char *c = static_cast<const char*>(p);
+    data_.insert(data_.end(), c, c + n);
+  }
+
+ public:
+  const char *data() const { return data_.data(); }
+  int size() const { return static_cast<int>(data_.size()); }
+
+  template <typename T>
+  void Visit(int index, T value) {
+    Append(&index, sizeof(index));
+    Append(&value, sizeof(value));
+  }
+};
+
+/// Write suffixes to a binary .sol file.
+/// Each suffix is written as records:
+/// the same 5 header ints as in a text .sol file,
+/// the name including the terminating 0,
+/// the table including the terminating 0 (if any),
+/// and the nonzero values as (int index, int or double value) pairs
+template <typename SuffixMap>
+void WriteBinarySuffixes(fmt::BufferedFile &file, const SuffixMap *suffixes) {
+  if (!suffixes)
+    return;
+  for (typename SuffixMap::iterator
+       i = suffixes->begin(), e = suffixes->end(); i != e; ++i) {
+    if ((i->kind() & suf::OUTPUT) == 0)
+      continue;
+    SuffixValueBinaryWriter writer;
+    i->VisitValues(writer);
+    int item_size = (i->kind() & suf::FLOAT) ? sizeof(double) : sizeof(int);
+    int num_values = writer.size() / (static_cast<int>(sizeof(int)) + item_size);
+    const char *name = i->name();
+    int mask = internal::SUFFIX_KIND_MASK | suf::FLOAT | suf::IODECL;
+    const auto& table = i->table();
+    int tablen = table.size() ? table.size()+1 : 0;
+    int tabNlines = table.empty()? 0 :
+                                   1+std::count(table.begin(), table.end(), '\n');
+    int header[] = { i->kind() & mask, num_values,
+                     static_cast<int>(std::strlen(name) + 1),
+                     tablen, tabNlines };
+    WriteBinaryRecord(file, header, sizeof(header));
+    WriteBinaryRecord(file, name, header[2]);
+    if (tablen)
+      WriteBinaryRecord(file, table.c_str(), tablen);
+    WriteBinaryRecord(file, writer.data(), writer.size());
+  }
+}
 }  // namespace internal
 
 /// Writes a solution to a .sol file
@@ -125,6 +207,46 @@ void WriteSolFile(fmt::CStringRef filename, const Solution &sol) {
     internal::WriteSuffixes(file, sol.suffixes(kinds[i]));
 }
 
+/// Writes a solution to a binary .sol file.
+/// The file consists of records, each written as
+/// its size in bytes (int), the data, and the size again:
+///   "binary";
+///   message lines, terminated by an empty record;
+///   ints: number of options, options,
+///     number of algebraic constraints, number of dual values,
+///     number of variables, number of primal values;
+///   dual values (if any), primal values (if any), as doubles;
+///   ints: objno, solve result code;
+///   suffixes, see WriteBinarySuffixes().
+template <typename Solution>
+void WriteBinarySolFile(fmt::CStringRef filename, const Solution &sol) {
+  fmt::BufferedFile file(filename, "wb");
+  internal::WriteBinaryRecord(file, "binary", 6);
+  internal::WriteBinaryMessage(file, sol.message());
+  std::vector<int> header;
+  header.push_back(sol.num_options());
+  for (int i = 0; i < sol.num_options(); ++i)
+    header.push_back(sol.option(i));
+  int num_values = sol.num_values(), num_dual_values = sol.num_dual_values();
+  header.push_back(sol.num_algebraic_cons());
+  header.push_back(num_dual_values);
+  header.push_back(sol.num_vars());
+  header.push_back(num_values);
+  internal::WriteBinaryRecord(file, header.data(),
+                              static_cast<int>(header.size() * sizeof(int)));
+  if (num_dual_values)
+    internal::WriteBinaryDoubles(file, num_dual_values,
+                                 [&sol](int i) { return sol.dual_value(i); });
+  if (num_values)
+    internal::WriteBinaryDoubles(file, num_values,
+                                 [&sol](int i) { return sol.value(i); });
+  int objno[] = { sol.objno()-1, sol.status() };
+  internal::WriteBinaryRecord(file, objno, sizeof(objno));
+  suf::Kind kinds[] = {suf::VAR, suf::CON, suf::OBJ, suf::PROBLEM};
+  for (std::size_t i = 0, n = sizeof(kinds) / sizeof(*kinds); i < n; ++i)
+    internal::WriteBinarySuffixes(file, sol.suffixes(kinds[i]));
+}
+
 }  // namepace mp
 
 #endif  // MP_SOL_H_
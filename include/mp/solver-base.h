@@ -4,6 +4,7 @@
 #include <map>
 
 #include "solver-opt.h"
+#include "mp/run-stats.h"
 
 namespace mp {
 
@@ -131,6 +132,15 @@ public:
     wantsol_ = value;
   }
 
+  /// sol:binary value
+  int GetSolBinary(const SolverOption &) const { return sol_binary_; }
+  /// set sol:binary
+  void SetSolBinary(const SolverOption &opt, int value) {
+    if (value < 0 || value > 2)
+      throw InvalidOptionValue(opt, value);
+    sol_binary_ = value;
+  }
+
   /// solution output filename stub
   std::string GetSolutionStub(const SolverOption &) const {
     return solution_stub_;
@@ -182,6 +192,15 @@ public:
   int wantsol() const { return wantsol_; }
   void set_wantsol(int value) { wantsol_ = value; }
 
+  /// Whether to write binary .sol files,
+  /// depending on the sol:binary option and the NL format
+  bool binary_sol() const
+  { return 1 == sol_binary_ || (2 == sol_binary_ && binary_nl_); }
+  /// Set sol:binary: 0 - text, 1 - binary, 2 - same as the NL file
+  void set_sol_binary(int value) { sol_binary_ = value; }
+  /// Record whether the NL file was binary
+  void set_binary_nl(bool f) { binary_nl_ = f; }
+
   // Returns true if -AMPL is specified.
   bool ampl_flag() { return (bool_options_ & AMPL_FLAG) != 0; }
   void set_ampl_flag(bool value = true) {
@@ -225,6 +244,23 @@ public:
   /// Returns true if the timing is enabled
   bool timing() const { return timing_; }
 
+  /// Run statistics, or nullptr if not collected.
+  /// Collected when option tech:timing:json is set
+  RunStats* GetRunStats() const
+  { return run_stats_file_.empty() ? nullptr : &run_stats_; }
+
+  /// Write run statistics as JSON, if requested
+  void WriteRunStats();
+
+  /// Get tech:timing:json
+  std::string GetRunStatsFile(const SolverOption &) const {
+    return run_stats_file_;
+  }
+  /// Set tech:timing:json
+  void SetRunStatsFile(const SolverOption &, fmt::StringRef value) {
+    run_stats_file_ = value.to_string();
+  }
+
   /// Return error handler
   ErrorHandler *error_handler() { return error_handler_; }
 
@@ -431,6 +467,8 @@ private:
   std::string license_info_;
   long date_{0};
   int wantsol_ {0};
+  int sol_binary_ {0};
+  bool binary_nl_ {false};
   int obj_precision_ {-1};
 
   /// Index of the objective to optimize starting from 1, 0 to ignore
@@ -457,6 +495,10 @@ private:
   bool timing_ {false};
   bool multiobj_ {false};
 
+  /// Run statistics and their JSON file
+  mutable RunStats run_stats_;
+  std::string run_stats_file_;
+
   bool has_errors_ {false};
   OutputHandler *output_handler_ {this};
   ErrorHandler *error_handler_ {this};
@@ -25,14 +25,16 @@ class SolutionAdapter {
   mp::ArrayRef<double> values_;
   mp::ArrayRef<double> dual_values_;
   int objno_;
+  bool binary_;
 
  public:
   SolutionAdapter(int status, ProblemBuilder *pb, const char *message,
                   mp::ArrayRef<int> options, mp::ArrayRef<double> values,
                   mp::ArrayRef<double> dual_values,
-                  int on)
+                  int on, bool binary = false)
     : status_(status), builder_(pb), message_(message), options_(options),
-      values_(values), dual_values_(dual_values), objno_(on) {}
+      values_(values), dual_values_(dual_values), objno_(on),
+      binary_(binary) {}
 
   int status() const { return status_; }
 
@@ -49,6 +51,9 @@ class SolutionAdapter {
 
   int objno() const { return objno_; }
 
+  /// Whether to write a binary .sol file
+  bool binary() const { return binary_; }
+
   int num_vars() const { return builder_->num_vars(); }
   int num_algebraic_cons() const { return builder_->num_algebraic_cons(); }
 
@@ -58,11 +63,15 @@ class SolutionAdapter {
 };
 
 /// The default .sol file writer.
+/// Writes a binary .sol file if sol.binary().
 class SolFileWriter {
  public:
   template <typename Solution>
   void Write(fmt::CStringRef filename, const Solution &sol) {
-    WriteSolFile(filename, sol);
+    if (sol.binary())
+      WriteBinarySolFile(filename, sol);
+    else
+      WriteSolFile(filename, sol);
   }
 };
 
@@ -132,7 +141,7 @@ void SolutionWriterImpl<Solver, PB, Writer>::HandleFeasibleSolution(
         MakeArrayRef(values, values ? builder_.num_vars() : 0),
         MakeArrayRef(dual_values,
                      dual_values ? builder_.num_algebraic_cons() : 0),
-        solver_.objno_used());
+        solver_.objno_used(), solver_.binary_sol());
   fmt::MemoryWriter filename;
   filename << solution_stub << num_solutions_ << ".sol";
   this->Write(filename.c_str(), sol);
@@ -159,7 +168,7 @@ void SolutionWriterImpl<Solver, PB, Writer>::HandleSolution(
         MakeArrayRef(values, values ? builder_.num_vars() : 0),
         MakeArrayRef(dual_values,
                      dual_values ? builder_.num_algebraic_cons() : 0),
-        solver_.objno_used());
+        solver_.objno_used(), solver_.binary_sol());
   
   std::string solFilePath;
   if (!overrideStub_.empty()) { 
@@ -229,6 +238,7 @@ void SolverNLHandlerImpl<Solver, PB, NLPB>::OnHeader(const NLHeader &h) {
   if (objno > h.num_objs && solver_.is_objno_specified())
     throw InvalidOptionValue("objno", objno,
                              fmt::format("expected value between 0 and {}", h.num_objs));
+  solver_.set_binary_nl(h.format == NLHeader::BINARY);
   num_options_ = h.num_ampl_options;
   std::copy(h.ampl_options, h.ampl_options + num_options_, options_);
   Base::OnHeader(h);
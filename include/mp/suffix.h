@@ -31,6 +31,7 @@
 #include <set>
 #include <string>      // for std::char_traits
 #include <memory>
+#include <vector>
 #include "mp/common.h"
 #include "mp/error.h"  // for MP_ASSERT
 #include "mp/format.h"
@@ -52,6 +53,18 @@ using SuffixTable = std::string;
 
 namespace internal {
 
+/// A suffix is stored sparsely if at most
+/// 1/SPARSE_SUFFIX_DENSITY_INV of its values are nonzero
+enum { SPARSE_SUFFIX_DENSITY_INV = 4 };
+
+/// Returns true if a suffix with \a num_nonzeros nonzeros
+/// out of \a num_values should be stored sparsely.
+/// Negative \a num_nonzeros means unknown.
+inline bool PreferSparseSuffix(int num_nonzeros, int num_values) {
+  return num_nonzeros >= 0 &&
+      num_nonzeros <= num_values / SPARSE_SUFFIX_DENSITY_INV;
+}
+
 class SuffixBase {
  protected:
   struct Impl {
@@ -67,27 +80,133 @@ class SuffixBase {
     };
     SuffixTable table;
 
+    /// Sparse storage, used instead of the values array if sparse:
+    /// indexes in increasing order and the corresponding values.
+    /// int values are exactly representable as double.
+    mutable bool sparse;
+    mutable std::vector<int> sp_index;
+    mutable std::vector<double> sp_value;
+
     explicit Impl(fmt::StringRef name, int kind = 0, int num_values = 0,
                   const SuffixTable& tab = {})
       : name(name), kind(kind), num_values(num_values), int_values(0),
-    table(tab) {}
+    table(tab), sparse(false) {}
 
     int kind_full() const { return kind; }
     int kind_pure() const { return kind & suf::KIND_MASK; }
+
+    /// Position of \a index in sp_index, or of the next greater one
+    std::size_t sparse_pos(int index) const {
+      return std::lower_bound(sp_index.begin(), sp_index.end(), index)
+          - sp_index.begin();
+    }
+
+    /// Get sparse value, 0 if not stored
+    double get_sparse(int index) const {
+      auto pos = sparse_pos(index);
+      return pos != sp_index.size() && sp_index[pos] == index ?
+            sp_value[pos] : 0.0;
+    }
+
+    /// Set sparse value. Increasing indexes are appended in O(1),
+    /// and zeros are not stored for new indexes.
+    void set_sparse(int index, double value) const {
+      if (sp_index.empty() || sp_index.back() < index) {
+        if (value) {
+          sp_index.push_back(index);
+          sp_value.push_back(value);
+        }
+        return;
+      }
+      auto pos = sparse_pos(index);
+      if (sp_index[pos] == index)
+        sp_value[pos] = value;
+      else if (value) {
+        sp_index.insert(sp_index.begin() + pos, index);
+        sp_value.insert(sp_value.begin() + pos, value);
+      }
+    }
+
+    /// Replace sparse values by the nonzeros of a dense array
+    template <typename T>
+    void assign_sparse(const T *values) const {
+      sp_index.clear();
+      sp_value.clear();
+      for (int i = 0; i < num_values; ++i) {
+        if (values[i]) {
+          sp_index.push_back(i);
+          sp_value.push_back(values[i]);
+        }
+      }
+    }
+
+    /// Scatter sparse values into a zero-initialized dense array
+    template <typename T>
+    void scatter_sparse(T *values) const {
+      for (std::size_t k = 0; k < sp_index.size(); ++k)
+        values[sp_index[k]] = static_cast<T>(sp_value[k]);
+    }
   };
 
   template <typename SuffixType>
   explicit SuffixBase(SuffixType s) : impl_(s.impl()) {}
 
   void get_value(int index, int &value) const {
-    value = impl_->int_values[index];
+    value = impl_->sparse ? static_cast<int>(impl_->get_sparse(index)) :
+                            impl_->int_values[index];
+  }
+  void set_value(int index, int value) {
+    if (impl_->sparse)
+      impl_->set_sparse(index, value);
+    else
+      impl_->int_values[index] = value;
   }
-  void set_value(int index, int value) { impl_->int_values[index] = value; }
 
   void get_value(int index, double &value) const {
-    value = impl_->dbl_values[index];
+    value = impl_->sparse ? impl_->get_sparse(index) :
+                            impl_->dbl_values[index];
+  }
+  void set_value(int index, double value) {
+    if (impl_->sparse)
+      impl_->set_sparse(index, value);
+    else
+      impl_->dbl_values[index] = value;
+  }
+
+  /// Set all values from a dense array of size num_values()
+  template <typename T>
+  void set_values(const T *values) {
+    if (impl_->sparse)
+      impl_->assign_sparse(values);
+    else
+      std::copy(values, values + impl_->num_values,
+                static_cast<T*>(impl_->values));
+  }
+
+  /// Visit nonzero values
+  template <typename T, typename Visitor>
+  void visit_values(Visitor &v) const {
+    if (impl_->sparse) {
+      for (std::size_t k = 0; k < impl_->sp_index.size(); ++k) {
+        if (T value = static_cast<T>(impl_->sp_value[k]))
+          v.Visit(impl_->sp_index[k], value);
+      }
+      return;
+    }
+    const T *values = static_cast<const T*>(impl_->values);
+    for (int i = 0, n = impl_->num_values; i < n; ++i) {
+      if (T value = values[i])
+        v.Visit(i, value);
+    }
+  }
+
+  /// Dense copy of sparse values
+  template <typename T>
+  std::vector<T> sparse_to_dense() const {
+    std::vector<T> result(impl_->num_values);
+    impl_->scatter_sparse(result.data());
+    return result;
   }
-  void set_value(int index, double value) { impl_->dbl_values[index] = value; }
 
   const Impl *impl() const { return impl_; }
 
@@ -122,6 +241,9 @@ class SuffixBase {
 
   int num_values() const { return impl_->num_values; }
 
+  /// Returns true if the values are stored sparsely
+  bool is_sparse() const { return impl_->sparse; }
+
   /// Don't use
   template <class T>
   ArrayRef<T> get_values() const { assert(0); return {}; }
@@ -141,12 +263,16 @@ class SuffixBase {
 template <> inline
 ArrayRef<int> SuffixBase::get_values<int>() const {
   assert(0 == (suf::FLOAT & kind()));
+  if (is_sparse())
+    return sparse_to_dense<int>();
   return { impl_->int_values, (std::size_t)num_values() };
 }
 
 template <> inline
 ArrayRef<double> SuffixBase::get_values<double>() const {
   assert(0 != (suf::FLOAT & kind()));
+  if (is_sparse())
+    return sparse_to_dense<double>();
   return { impl_->dbl_values, (std::size_t)num_values() };
 }
 
@@ -177,6 +303,7 @@ class Suffix : private internal::SuffixBase {
   using SuffixBase::name;
   using SuffixBase::kind;
   using SuffixBase::num_values;
+  using SuffixBase::is_sparse;
   using SuffixBase::table;
   using SuffixBase::impl;
   using SuffixBase::operator SafeBool;
@@ -237,8 +364,11 @@ class BasicSuffix : private internal::SuffixBase {
   using SuffixBase::kind;
   using SuffixBase::or_kind;
   using SuffixBase::num_values;
+  using SuffixBase::is_sparse;
   using SuffixBase::operator SafeBool;
 
+  /// Returns the values as an array.
+  /// For a sparse suffix this is a dense copy.
   ArrayRef<T> get_values() const {
     return SuffixBase::get_values<T>();
   }
@@ -250,12 +380,11 @@ class BasicSuffix : private internal::SuffixBase {
     return result;
   }
 
+  /// Iterates over nonzero values in increasing index order.
+  /// For a sparse suffix, only the stored values are visited.
   template <typename Visitor>
   void VisitValues(Visitor &v) const {
-    for (int i = 0, n = num_values(); i < n; ++i) {
-      if (T value = this->value(i))
-        v.Visit(i, value);
-    }
+    this->template visit_values<T>(v);
   }
 };
 
@@ -282,6 +411,14 @@ class BasicMutSuffix : public BasicSuffix<T> {
               index < this->impl()->num_values, "index out of bounds");
     BasicSuffix<T>::set_value(index, value);
   }
+
+  /// Sets all values from \a values of size >= num_values().
+  /// A sparse suffix stores only the nonzeros.
+  void set_values(ArrayRef<T> values) {
+    MP_ASSERT(values.size() >= (std::size_t)this->num_values(),
+              "too few values");
+    BasicSuffix<T>::template set_values<T>(values.data());
+  }
 };
 
 typedef BasicSuffix<int> IntSuffix;
@@ -391,6 +528,34 @@ class BasicSuffixSet : private Alloc {
     return BasicMutSuffix<T>(impl);
   }
 
+  /// Adds a suffix expecting at most \a num_nonzeros nonzero values
+  /// (negative if unknown). The values are stored sparsely
+  /// if internal::PreferSparseSuffix(), otherwise densely as in Add().
+  template <typename T>
+  BasicMutSuffix<T> AddForNonzeros(
+      fmt::StringRef name, int kind, int num_values, int num_nonzeros,
+      const SuffixTable& table = {}) {
+    if (!internal::PreferSparseSuffix(num_nonzeros, num_values))
+      return Add<T>(name, kind, num_values, table);
+    MP_ASSERT((kind & suf::FLOAT) == 0 ||
+              (kind & suf::FLOAT) == internal::SuffixInfo<T>::KIND,
+              "invalid suffix kind");
+    SuffixImpl *impl = DoAdd(
+          name, kind | internal::SuffixInfo<T>::KIND, num_values, table);
+    impl->sparse = true;
+    impl->sp_index.reserve(num_nonzeros);
+    impl->sp_value.reserve(num_nonzeros);
+    return BasicMutSuffix<T>(impl);
+  }
+
+  /// Switches suffix \a s between sparse and dense storage,
+  /// keeping its values.
+  void SetSparse(MutSuffix s, bool sparse);
+
+  /// Exchanges suffixes with \a other.
+  /// Both sets should use equal allocators.
+  void swap(BasicSuffixSet &other) { set_.swap(other.set_); }
+
   /// Finds a suffix with the specified name.
   Suffix Find(fmt::StringRef name) const {
     typename Set::iterator i = set_.find(SuffixImpl(name));
@@ -455,6 +620,8 @@ BasicSuffixSet<Alloc>::~BasicSuffixSet() {
   /// Deallocate names and values.
   for (typename Set::iterator i = set_.begin(), e = set_.end(); i != e; ++i) {
     Deallocate(const_cast<char*>(i->name.data()), i->name.size()+1);
+    if (i->sparse)
+      continue;
     if ((i->kind & suf::FLOAT) != 0)
       Deallocate(i->dbl_values, i->num_values);
     else
@@ -484,6 +651,41 @@ typename BasicSuffixSet<Alloc>::SuffixImpl *BasicSuffixSet<Alloc>::DoAdd(
   return impl;
 }
 
+template <typename Alloc>
+void BasicSuffixSet<Alloc>::SetSparse(MutSuffix s, bool sparse) {
+  const SuffixImpl *impl = s.impl();
+  if (impl->sparse == sparse)
+    return;
+  SuffixImpl *mimpl = const_cast<SuffixImpl*>(impl);
+  std::size_t n = impl->num_values;
+  bool is_float = (impl->kind & suf::FLOAT) != 0;
+  if (sparse) {
+    if (is_float)
+      impl->assign_sparse(impl->dbl_values);
+    else
+      impl->assign_sparse(impl->int_values);
+    if (is_float)
+      Deallocate(impl->dbl_values, n);
+    else
+      Deallocate(impl->int_values, n);
+    mimpl->values = 0;
+  } else {
+    if (is_float) {
+      double *values = Allocate<double>(n);
+      std::fill_n(fmt::internal::make_ptr(values, n), n, 0);
+      impl->scatter_sparse(values);
+      mimpl->values = values;
+    } else {
+      int *values = Allocate<int>(n);
+      std::fill_n(fmt::internal::make_ptr(values, n), n, 0);
+      impl->scatter_sparse(values);
+      mimpl->values = values;
+    }
+    std::vector<int>().swap(impl->sp_index);
+    std::vector<double>().swap(impl->sp_value);
+  }
+  impl->sparse = sparse;
+}
 
 /// Typedef SuffixSet.
 typedef BasicSuffixSet< std::allocator<char> > SuffixSet;
@@ -519,6 +721,12 @@ class SuffixManager {
     Check(kind);
     return suffixes_[kind];
   }
+
+  /// Exchanges suffixes of all kinds with \a other
+  void SwapSuffixes(SuffixManager &other) {
+    for (int i = 0; i < internal::NUM_SUFFIX_KINDS; ++i)
+      suffixes_[i].swap(other.suffixes_[i]);
+  }
 };
 
 
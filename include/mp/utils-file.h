@@ -47,6 +47,16 @@ public:
 /// FileAppender maker
 std::unique_ptr<BasicFileAppender> MakeFileAppender();
 
+/// Read whole (binary) file into \a s.
+/// @return false if failed
+bool ReadFileToString(const std::string& fln, std::string& s);
+
+/// Write \a s into a (binary) file.
+/// Writes a temporary file first and renames it,
+/// so that concurrent readers never see a partial file.
+/// @return false if failed
+bool WriteStringToFile(const std::string& fln, const std::string& s);
+
 }  // namespace mp
 
 #endif  // MP_UTILS_FILE_H_
@@ -0,0 +1,178 @@
+#ifndef UTILSSERIALIZE_H
+#define UTILSSERIALIZE_H
+
+/// Binary serialization of model data, e.g., for caches.
+///
+/// Values are written by overloads of
+///   void Serialize(BinaryWriter& , const T& ),
+/// and read back by overloads of
+///   T Deserialize(BinaryReader& , T* ),
+/// where the null pointer of type T* selects the type read.
+/// Overloads for further types (e.g., constraints)
+/// should be declared in namespace mp, see constr_serialize.h.
+/// The format is the host's binary representation:
+/// intended for a cache on the same machine, not for exchange.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <array>
+#include <utility>
+#include <type_traits>
+
+#include "mp/error.h"
+
+namespace mp {
+
+/// Binary writer: appends data to a memory buffer
+class BinaryWriter {
+public:
+  /// Append \a n bytes
+  void Append(const void* p, std::size_t n)
+  { buf_.append((const char*)p, n); }
+
+  /// The data written
+  const std::string& GetData() const { return buf_; }
+
+private:
+  std::string buf_;
+};
+
+
+/// Binary reader from a memory buffer
+class BinaryReader {
+public:
+  /// Construct from a buffer, which should outlive the reader
+  BinaryReader(const std::string& buf) :
+    p_(buf.data()), end_(buf.data()+buf.size()) { }
+
+  /// Extract \a n bytes
+  void Extract(void* p, std::size_t n) {
+    if ((std::size_t)(end_-p_) < n)
+      MP_RAISE("Binary data: unexpected end");
+    std::memcpy(p, p_, n);
+    p_ += n;
+  }
+
+  /// Whether all data has been read
+  bool AtEnd() const { return p_==end_; }
+
+private:
+  const char* p_;
+  const char* const end_;
+};
+
+
+/// Serialize an arithmetic or enum value
+template <class T>
+typename std::enable_if<
+  std::is_arithmetic<T>::value || std::is_enum<T>::value >::type
+Serialize(BinaryWriter& wrt, T v) { wrt.Append(&v, sizeof(v)); }
+
+/// Deserialize an arithmetic or enum value
+template <class T>
+typename std::enable_if<
+  std::is_arithmetic<T>::value || std::is_enum<T>::value, T >::type
+Deserialize(BinaryReader& rd, T* ) {
+  T v;
+  rd.Extract(&v, sizeof(v));
+  return v;
+}
+
+/// Serialize a container size
+inline void SerializeSize(BinaryWriter& wrt, std::size_t n)
+{ Serialize(wrt, (std::uint64_t)n); }
+
+/// Deserialize a container size
+inline std::size_t DeserializeSize(BinaryReader& rd)
+{ return (std::size_t)Deserialize(rd, (std::uint64_t*)nullptr); }
+
+/// Serialize std::string
+inline void Serialize(BinaryWriter& wrt, const std::string& s) {
+  SerializeSize(wrt, s.size());
+  wrt.Append(s.data(), s.size());
+}
+
+/// Deserialize std::string
+inline std::string Deserialize(BinaryReader& rd, std::string* ) {
+  std::string s(DeserializeSize(rd), '\0');
+  if (s.size())
+    rd.Extract(&s[0], s.size());
+  return s;
+}
+
+/// Serialize std::vector<> of arithmetic values: in one go
+template <class T>
+typename std::enable_if< std::is_arithmetic<T>::value >::type
+Serialize(BinaryWriter& wrt, const std::vector<T>& v) {
+  SerializeSize(wrt, v.size());
+  wrt.Append(v.data(), v.size()*sizeof(T));
+}
+
+/// Deserialize std::vector<> of arithmetic values
+template <class T>
+typename std::enable_if<
+  std::is_arithmetic<T>::value, std::vector<T> >::type
+Deserialize(BinaryReader& rd, std::vector<T>* ) {
+  std::vector<T> v(DeserializeSize(rd));
+  if (v.size())
+    rd.Extract(v.data(), v.size()*sizeof(T));
+  return v;
+}
+
+/// Serialize std::vector<> of other values
+template <class T>
+typename std::enable_if< !std::is_arithmetic<T>::value >::type
+Serialize(BinaryWriter& wrt, const std::vector<T>& v) {
+  SerializeSize(wrt, v.size());
+  for (const auto& el: v)
+    Serialize(wrt, el);
+}
+
+/// Deserialize std::vector<> of other values
+template <class T>
+typename std::enable_if<
+  !std::is_arithmetic<T>::value, std::vector<T> >::type
+Deserialize(BinaryReader& rd, std::vector<T>* ) {
+  std::vector<T> v;
+  auto n = DeserializeSize(rd);
+  v.reserve(n);
+  for (std::size_t i=0; i<n; ++i)
+    v.push_back(Deserialize(rd, (T*)nullptr));
+  return v;
+}
+
+/// Serialize std::array<>
+template <class T, std::size_t N>
+void Serialize(BinaryWriter& wrt, const std::array<T, N>& a) {
+  for (const auto& el: a)
+    Serialize(wrt, el);
+}
+
+/// Deserialize std::array<>
+template <class T, std::size_t N>
+std::array<T, N> Deserialize(BinaryReader& rd, std::array<T, N>* ) {
+  std::array<T, N> a;
+  for (auto& el: a)
+    el = Deserialize(rd, (T*)nullptr);
+  return a;
+}
+
+/// Serialize std::pair<>
+template <class T1, class T2>
+void Serialize(BinaryWriter& wrt, const std::pair<T1, T2>& pr) {
+  Serialize(wrt, pr.first);
+  Serialize(wrt, pr.second);
+}
+
+/// Deserialize std::pair<>
+template <class T1, class T2>
+std::pair<T1, T2> Deserialize(BinaryReader& rd, std::pair<T1, T2>* ) {
+  auto first = Deserialize(rd, (T1*)nullptr);
+  return { std::move(first), Deserialize(rd, (T2*)nullptr) };
+}
+
+} // namespace mp
+
+#endif // UTILSSERIALIZE_H
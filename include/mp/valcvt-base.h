@@ -7,6 +7,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <algorithm>
 #include <cassert>
 
@@ -89,14 +90,19 @@ public:
           a2.second;
   }
 
-  /// Assign from another map
+  /// Assign from another map.
+  /// Existing arrays are assigned in place, only missing keys
+  /// create new arrays
   template <class Array2>
   ValueMap& operator=(const ValueMap<Array2>& m) {
-    for (const auto& a2: m.GetMap())
-      map_.insert({
-                    a2.first, CreateArray<Array, Param>(prm_)
-                  }).first->second =
-          a2.second;
+    for (const auto& a2: m.GetMap()) {
+      auto it = map_.find(a2.first);
+      if (map_.end() == it)
+        it = map_.insert({
+                           a2.first, CreateArray<Array, Param>(prm_)
+                         }).first;
+      it->second = a2.second;
+    }
     return *this;
   }
 
@@ -313,6 +319,22 @@ public:
   LIST_PRESOLVE_METHODS
 
 
+  /// Postsolve several solutions, e.g., a solution pool.
+  /// Default: one by one
+  virtual std::vector< MVOverEl<double> > PostsolveSolutions(
+      const std::vector< MVOverEl<double> >& mvs) {
+    std::vector< MVOverEl<double> > result;
+    result.reserve(mvs.size());
+    for (const auto& mv: mvs)
+      result.push_back(PostsolveSolution(mv));
+    return result;
+  }
+
+  /// Check primal solution \a x of the presolved model,
+  /// e.g., report constraint violations.
+  /// Backends call this after postsolving the solution
+  virtual void CheckPresolvedSolution(ArrayRef<double> x) { (void)x; }
+
   /// Register a ValueNode*
   virtual void Register(ValueNode* ) = 0;
 
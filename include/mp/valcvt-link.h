@@ -4,10 +4,12 @@
 #include <array>
 #include <vector>
 #include <deque>
+#include <unordered_map>
 #include <algorithm>
 #include <mp/arrayref.h>
 
 #include "mp/common.h"
+#include "mp/utils-serialize.h"
 #include "valcvt-node.h"
 
 
@@ -31,11 +33,13 @@ class ValuePresolver;
 /// All concrete nodes are of the same type.
 class BasicLink {
 public:
-  /// Constructor
-  BasicLink(ValuePresolver& pre) : value_presolver_(pre) { }
+  /// Constructor.
+  /// Registers with the ValuePresolver
+  BasicLink(ValuePresolver& pre);
 
-  /// Virtual destructor
-  virtual ~BasicLink() = default;
+  /// Virtual destructor.
+  /// Deregisters with the ValuePresolver
+  virtual ~BasicLink();
 
   /// Type name
   virtual const char* GetTypeName() const = 0;
@@ -64,6 +68,28 @@ public:
   /// This is used for graph export
   virtual void ExportEntryItems(EntryItems& ei, int i) const = 0;
 
+  /// Number of link entries
+  virtual int GetNumberOfEntries() const = 0;
+
+  /// Approximate memory taken by the link entries, bytes
+  virtual size_t GetEntriesMemory() const = 0;
+
+  /// Node ids, used to serialize node ranges
+  using NodeIds = std::unordered_map<const ValueNode*, int>;
+
+  /// Nodes by id, used to deserialize node ranges
+  using NodesById = std::vector<ValueNode*>;
+
+  /// Serialize the link entries
+  virtual void SerializeEntries(
+      BinaryWriter& wrt, const NodeIds& ids) const = 0;
+
+  /// Replace the link entries by deserialized ones.
+  /// Does not register link index ranges:
+  /// the ValuePresolver restores them itself
+  virtual void DeserializeEntries(
+      BinaryReader& rd, const NodesById& nodes) = 0;
+
 
 protected:
   /// Add a range of link entries to the Presolver's list.
@@ -82,6 +108,51 @@ private:
 };
 
 
+/// Serialize a NodeRange as (node id, begin, end)
+inline void SerializeNodeRange(BinaryWriter& wrt, NodeRange nr,
+                               const BasicLink::NodeIds& ids) {
+  Serialize(wrt, ids.at(nr.GetValueNode()));
+  Serialize(wrt, nr.GetIndexRange().beg_);
+  Serialize(wrt, nr.GetIndexRange().end_);
+}
+
+/// Deserialize a NodeRange
+inline NodeRange DeserializeNodeRange(BinaryReader& rd,
+                                      const BasicLink::NodesById& nodes) {
+  auto id = Deserialize(rd, (int*)nullptr);
+  auto beg = Deserialize(rd, (int*)nullptr);
+  auto end = Deserialize(rd, (int*)nullptr);
+  if (id<0 || id>=(int)nodes.size() || beg>=end ||
+      end>(int)nodes[id]->Size())
+    MP_RAISE("Link data: invalid node range");
+  return { nodes[id], {beg, end} };
+}
+
+/// Serialize pairs of NodeRange's, as stored by CopyLink
+/// and One2ManyLink
+template <class Entries>
+void SerializeNodeRangePairs(BinaryWriter& wrt, const Entries& entries,
+                             const BasicLink::NodeIds& ids) {
+  SerializeSize(wrt, entries.size());
+  for (const auto& en: entries) {
+    SerializeNodeRange(wrt, en.first, ids);
+    SerializeNodeRange(wrt, en.second, ids);
+  }
+}
+
+/// Deserialize pairs of NodeRange's
+template <class Entries>
+void DeserializeNodeRangePairs(BinaryReader& rd, Entries& entries,
+                               const BasicLink::NodesById& nodes) {
+  entries.clear();
+  auto n = DeserializeSize(rd);
+  for (std::size_t i=0; i<n; ++i) {
+    auto nr1 = DeserializeNodeRange(rd, nodes);
+    entries.push_back( { nr1, DeserializeNodeRange(rd, nodes) } );
+  }
+}
+
+
 /// Link range: range of conversion specifiers of certain type.
 /// The link is specified as well
 struct LinkRange {
@@ -155,6 +226,23 @@ public:
     ei.dest_items_.push_back(en.second);
   }
 
+  /// Number of link entries
+  int GetNumberOfEntries() const override { return (int)entries_.size(); }
+
+  /// Memory taken by the link entries
+  size_t GetEntriesMemory() const override
+  { return entries_.size() * sizeof(LinkEntry); }
+
+  /// Serialize the link entries
+  void SerializeEntries(
+      BinaryWriter& wrt, const NodeIds& ids) const override
+  { SerializeNodeRangePairs(wrt, entries_, ids); }
+
+  /// Deserialize the link entries
+  void DeserializeEntries(
+      BinaryReader& rd, const NodesById& nodes) override
+  { DeserializeNodeRangePairs(rd, entries_, nodes); }
+
   /// Copy everything, MaxAmongNon0 should not apply
 #undef PRESOLVE_KIND
 #define PRESOLVE_KIND(name, ValType) \
@@ -193,7 +281,12 @@ private:
 /// into a range of values.
 /// Useful to transfer values into expression subtree,
 /// in conversions, e.g., form 1 var / constraint / objective
-/// into several new ones
+/// into several new ones.
+///
+/// Consecutive sources with equally wide consecutive target
+/// ranges are run-length compressed into a single entry:
+/// source range [s, s+n) and target range [d, d+n*w),
+/// where source s+k maps to targets [d+k*w, d+(k+1)*w).
 class One2ManyLink : public BasicLink {
 public:
   /// Constructor
@@ -204,23 +297,36 @@ public:
 
   /// Single link entry,
   /// stores src + dest ranges.
-  /// HOWEVER the source range keeps just 1 node.
+  /// The dest range is a multiple of the source range,
+  /// see the class description.
   using LinkEntry = std::pair<NodeRange, NodeRange>;
 
   /// Collection of entries
   using CollectionOfEntries = std::deque<LinkEntry>;
 
-  /// Add entry.
+  /// Add entry with a single source index.
   /// Instead of a new entry, tries to extend the last one
-  /// if exists
+  /// if exists: either by more targets of the same source,
+  /// or by the next source with as many next targets
   void AddEntry(LinkEntry be) {
     assert(be.first.IsSingleIndex());
-    if (entries_.empty() ||
-        entries_.back().first!=be.first ||
-        !entries_.back().second.TryExtendBy(be.second)) {
-      entries_.push_back(be);             // Add new entry
-      RegisterLinkIndex(entries_.size()-1);
+    if (!entries_.empty()) {
+      auto& last = entries_.back();
+      if (last.first.IsSingleIndex() &&
+          last.first.GetValueNode()==be.first.GetValueNode() &&
+          last.first.GetSingleIndex()==be.first.GetSingleIndex() &&
+          last.second.TryExtendBy(be.second))
+        return;                           // Widened the last entry
+      if (last.first.ExtendableBy(be.first) &&
+          last.second.ExtendableBy(be.second) &&
+          GetWidth(last)==be.second.GetIndexRange().Size()) {
+        last.first.ExtendBy(be.first);    // Next source
+        last.second.ExtendBy(be.second);
+        return;
+      }
     }
+    entries_.push_back(be);               // Add new entry
+    RegisterLinkIndex(entries_.size()-1);
   }
 
   /// Get source/target nodes for a given link entry.
@@ -233,6 +339,23 @@ public:
     ei.dest_items_.push_back(en.second);
   }
 
+  /// Number of link entries
+  int GetNumberOfEntries() const override { return (int)entries_.size(); }
+
+  /// Memory taken by the link entries
+  size_t GetEntriesMemory() const override
+  { return entries_.size() * sizeof(LinkEntry); }
+
+  /// Serialize the link entries
+  void SerializeEntries(
+      BinaryWriter& wrt, const NodeIds& ids) const override
+  { SerializeNodeRangePairs(wrt, entries_, ids); }
+
+  /// Deserialize the link entries
+  void DeserializeEntries(
+      BinaryReader& rd, const NodesById& nodes) override
+  { DeserializeNodeRangePairs(rd, entries_, nodes); }
+
   /// All pre- / postsolves just take max from non-0
 #undef PRESOLVE_KIND
 #define PRESOLVE_KIND(name, ValType) \
@@ -244,26 +367,38 @@ public:
   LIST_PRESOLVE_METHODS
 
 protected:
-  /// Distribute values of type T from nr1 to nr2
+  /// Number of targets per source in entry \a en
+  static int GetWidth(const LinkEntry& en) {
+    assert(0 == en.second.GetIndexRange().Size()
+           % en.first.GetIndexRange().Size());
+    return en.second.GetIndexRange().Size()
+        / en.first.GetIndexRange().Size();
+  }
+
+  /// Distribute values of type T from nr1 to nr2,
+  /// \a w targets per source
   template <class T>
-  void Distr(NodeRange nr1, NodeRange nr2) {
-    assert(nr1.IsSingleIndex());
-    auto val = nr1.GetValueNode()->
-        GetVal<T>(nr1.GetSingleIndex());
-    for (auto i=nr2.GetIndexRange().beg_;
-         i!=nr2.GetIndexRange().end_; ++i)
-      nr2.GetValueNode()->SetVal(i, val);
+  void Distr(NodeRange nr1, NodeRange nr2, int w) {
+    auto i2 = nr2.GetIndexRange().beg_;
+    for (auto i1=nr1.GetIndexRange().beg_;
+         i1!=nr1.GetIndexRange().end_; ++i1) {
+      auto val = nr1.GetValueNode()->GetVal<T>(i1);
+      for (auto i2_end=i2+w; i2!=i2_end; ++i2)
+        nr2.GetValueNode()->SetVal(i2, val);
+    }
   }
 
-  /// Collect values of type T from nr2 to nr1
+  /// Collect values of type T from nr2 to nr1,
+  /// \a w targets per source
   template <class T>
-  void Collect(NodeRange nr1, NodeRange nr2) {
-    assert(nr1.IsSingleIndex());
-    auto nr1_idx = nr1.GetSingleIndex();
+  void Collect(NodeRange nr1, NodeRange nr2, int w) {
     auto& vec2 = nr2.GetValueNode()->GetValVec<T>();
-    for (auto i=nr2.GetIndexRange().beg_;
-         i!=nr2.GetIndexRange().end_; ++i)
-      nr1.GetValueNode()->SetVal(nr1_idx, vec2.at(i));
+    auto i2 = nr2.GetIndexRange().beg_;
+    for (auto i1=nr1.GetIndexRange().beg_;
+         i1!=nr1.GetIndexRange().end_; ++i1) {
+      for (auto i2_end=i2+w; i2!=i2_end; ++i2)
+        nr1.GetValueNode()->SetVal(i1, vec2.at(i2));
+    }
   }
 
   /// Src -> dest for the entries index range ir
@@ -271,7 +406,7 @@ protected:
   void DistributeFromSrc2Dest(LinkIndexRange ir) {
     for (int i=ir.beg_; i!=ir.end_; ++i) {
       const auto& br = entries_[i];
-      Distr<T>(br.first, br.second);
+      Distr<T>(br.first, br.second, GetWidth(br));
     }
   }
 
@@ -280,7 +415,7 @@ protected:
   void CollectFromDest2Src(LinkIndexRange ir) {
     for (int i=ir.end_; (i--)!=ir.beg_; ) {
       const auto& br = entries_[i];
-      Collect<T>(br.first, br.second);
+      Collect<T>(br.first, br.second, GetWidth(br));
     }
   }
 
@@ -327,6 +462,31 @@ public:
     MPCD( FillEntryItems( ei, entries_.at(i) ) );
   }
 
+  /// Number of link entries
+  int GetNumberOfEntries() const override { return (int)entries_.size(); }
+
+  /// Memory taken by the link entries
+  size_t GetEntriesMemory() const override
+  { return entries_.size() * sizeof(LinkEntry); }
+
+  /// Serialize the link entries.
+  /// They refer to the link's own nodes by index
+  void SerializeEntries(
+      BinaryWriter& wrt, const NodeIds& ) const override {
+    SerializeSize(wrt, entries_.size());
+    for (const auto& en: entries_)
+      Serialize(wrt, en);
+  }
+
+  /// Deserialize the link entries
+  void DeserializeEntries(
+      BinaryReader& rd, const NodesById& ) override {
+    entries_.clear();
+    auto n = DeserializeSize(rd);
+    for (std::size_t i=0; i<n; ++i)
+      entries_.push_back(Deserialize(rd, (LinkEntry*)nullptr));
+  }
+
 
   /// Pre- / postsolve loops over link entries
   /// and calls the derived class' method for each.
@@ -92,8 +92,8 @@ public:
 
   /// Move constructor
   ValueNode(ValueNode&& vn) : pre_(vn.pre_) {
-    vi_ = std::move(vn.vi_);
-    vd_ = std::move(vn.vd_);
+    slots_ = std::move(vn.slots_);
+    vn.slots_.resize(1);                 // keep vn usable
     sz_ = std::move(vn.sz_);
     name_ = std::move(vn.name_);
     RegisterMe();
@@ -101,8 +101,7 @@ public:
 
   /// Copy constructor
   ValueNode(const ValueNode& vn) : pre_(vn.pre_) {
-    vi_ = (vn.vi_);
-    vd_ = (vn.vd_);
+    slots_ = (vn.slots_);
     sz_ = (vn.sz_);
     name_ = (vn.name_);
     RegisterMe();
@@ -113,7 +112,7 @@ public:
 
   /// bool empty(). True when actual values are empty or 0.
   bool empty() const {
-    return EmptyOr0(vi_) && EmptyOr0(vd_);
+    return EmptyOr0(VI()) && EmptyOr0(VD());
   }
 
   /// Declared size (what is being used by links)
@@ -148,8 +147,8 @@ public:
   ValueNode& operator=(std::vector<int> ai)
   {
     // assert(ai.size() <= size());
-    vi_ = std::move(ai);
-    vi_.resize(Size());       // cut off / complement values
+    VI() = std::move(ai);
+    VI().resize(Size());       // cut off / complement values
     return *this;
   }
 
@@ -157,16 +156,16 @@ public:
   ValueNode& operator=(std::vector<double> ad)
   {
     // assert(ad.size() <= size());
-    vd_ = std::move(ad);
-    vd_.resize(Size());       // cut off / complement values
+    VD() = std::move(ad);
+    VD().resize(Size());       // cut off / complement values
     return *this;
   }
 
   /// Retrieve whole ArrayRef<int>
-  operator ArrayRef<int> () const { return vi_; }
+  operator ArrayRef<int> () const { return VI(); }
 
   /// Retrieve whole ArrayRef<double>
-  operator ArrayRef<double> () const { return vd_; }
+  operator ArrayRef<double> () const { return VD(); }
 
   /// Retrieve vec<T>& - dummy version
   template <class T>
@@ -174,10 +173,10 @@ public:
   { assert(false); static std::vector<T> dum; return dum; }
 
   /// Retrieve whole const vector<int>&
-  operator const std::vector<int>& () const { return vi_; }
+  operator const std::vector<int>& () const { return VI(); }
 
   /// Retrieve whole vector<double>&
-  operator const std::vector<double>& () const { return vd_; }
+  operator const std::vector<double>& () const { return VD(); }
 
 
   /////////////////////// Access individual values ///////////////////////
@@ -191,18 +190,18 @@ public:
   void SetVal(size_t i, T ) { assert(i<Size()); }
 
   /// Retrieve int[i]
-  int GetInt(size_t i) const { assert(i<vi_.size()); return vi_[i]; }
+  int GetInt(size_t i) const { assert(i<VI().size()); return VI()[i]; }
 
   /// Set int[i].
   /// If existing value non-0, only allow larger value.
-  void SetInt(size_t i, int v) { SetNum(vi_, i, v); }
+  void SetInt(size_t i, int v) { SetNum(VI(), i, v); }
 
   /// Retrieve double[i]
-  double GetDbl(size_t i) const { assert(i<vd_.size()); return vd_[i]; }
+  double GetDbl(size_t i) const { assert(i<VD().size()); return VD()[i]; }
 
   /// Set double[i].
   /// If existing value non-0, only allow larger value.
-  void SetDbl(size_t i, double v) { SetNum(vd_, i, v); }
+  void SetDbl(size_t i, double v) { SetNum(VD(), i, v); }
 
   /// GetName
   const std::string& GetName() const { return name_; }
@@ -212,10 +211,30 @@ public:
 
   /// Clean up and realloc with current size, fill by 0's
   void CleanUpAndRealloc() {
-    vi_.clear(); vd_.clear();
-    vi_.resize(Size()); vd_.resize(Size());
+    VI().clear(); VD().clear();
+    VI().resize(Size()); VD().resize(Size());
   }
 
+  /// Value slot used by the calling thread.
+  /// Each slot is a separate set of value arrays,
+  /// so that several threads can propagate
+  /// different solutions through the same graph.
+  /// Slot 0 is the default one.
+  static int& CurrentSlot() {
+    static thread_local int slot = 0;
+    return slot;
+  }
+
+  /// Make sure slots 0..n-1 exist.
+  /// Not thread-safe: call before starting the threads
+  void ReserveSlots(size_t n) {
+    if (slots_.size() < n)
+      slots_.resize(n);
+  }
+
+  /// Free all slots but the default one
+  void ReleaseSlots() { slots_.resize(1); }
+
 protected:
   /// Set int[i] or dbl[i].
   /// If existing value non-0, only allow larger value,
@@ -253,21 +272,44 @@ protected:
             { return v; }));
   }
 
+  /// The int values of the current slot, const
+  const std::vector<int>& VI() const
+  { assert(CurrentSlot() < (int)slots_.size());
+    return slots_[CurrentSlot()].vi_; }
+  /// The int values of the current slot
+  std::vector<int>& VI()
+  { assert(CurrentSlot() < (int)slots_.size());
+    return slots_[CurrentSlot()].vi_; }
+
+  /// The double values of the current slot, const
+  const std::vector<double>& VD() const
+  { assert(CurrentSlot() < (int)slots_.size());
+    return slots_[CurrentSlot()].vd_; }
+  /// The double values of the current slot
+  std::vector<double>& VD()
+  { assert(CurrentSlot() < (int)slots_.size());
+    return slots_[CurrentSlot()].vd_; }
+
 private:
+  /// A set of int and double values
+  struct ValueSlot {
+    std::vector<int> vi_;
+    std::vector<double> vd_;
+  };
+
   // Move & copy constructors should copy all members!
   BasicValuePresolver& pre_;
-  std::vector<int> vi_;
-  std::vector<double> vd_;
+  std::vector<ValueSlot> slots_ = std::vector<ValueSlot>(1);
   size_t sz_=0;
   std::string name_ = "default_value_node";
 };
 
 
 template <>
-std::vector<double>& ValueNode::GetValVec<double>() { return vd_; }
+std::vector<double>& ValueNode::GetValVec<double>() { return VD(); }
 
 template <>
-std::vector<int>& ValueNode::GetValVec<int>() { return vi_; }
+std::vector<int>& ValueNode::GetValVec<int>() { return VI(); }
 
 template <>
 double ValueNode::GetVal<double>(size_t i) const { return GetDbl(i); }
@@ -6,8 +6,13 @@
   */
 
 #include <deque>
+#include <map>
+#include <string>
 #include <unordered_set>
+#include <unordered_map>
 #include <functional>
+#include <thread>
+#include <algorithm>
 
 #include "valcvt-node.h"
 #include "valcvt-link.h"
@@ -49,6 +54,8 @@ public:
   using Base::rend;
   /// using Base::back()
   using Base::back;
+  /// using Base::clear()
+  using Base::clear;
 };
 
 
@@ -60,9 +67,12 @@ public:
   /// Exporter functor type
   using ExporterFn = std::function< void (const char*) >;
 
+  /// Solution checker functor type
+  using SolCheckerFn = std::function< void (ArrayRef<double>) >;
+
   /// Constructor
-  ValuePresolver(Env& env, ExporterFn bts={}) :
-    BasicValuePresolver(env), bts_(bts) { }
+  ValuePresolver(Env& env, ExporterFn bts={}, SolCheckerFn sc={}) :
+    BasicValuePresolver(env), bts_(bts), sc_(sc) { }
 
   /// Source nodes of the conversion graph, const
   const ModelValuesTerminal& GetSourceNodes() const { return src_; }
@@ -99,6 +109,30 @@ public:
   /// Check that the whole entries list has been exported
   bool AllEntriesExported() const { return brl_.size()==(size_t)i_exported_; }
 
+  /// Print number of entries and their memory
+  /// per link type, and the link range list size
+  void PrintLinkStats(Env& env) const {
+    size_t mem_total = 0;
+    auto stats = GetLinkStats(mem_total);
+    env.Print("Value presolver links: {} bytes, {} link ranges\n",
+              mem_total, brl_.size());
+    for (const auto& st: stats)
+      env.Print("  {:<40} {:>9} entries, {:>11} bytes\n",
+                st.first, st.second.first, st.second.second);
+  }
+
+  /// Record number of entries and their memory per link type
+  void AddRunStats(RunStats& rs) const {
+    size_t mem_total = 0;
+    auto stats = GetLinkStats(mem_total);
+    for (const auto& st: stats) {
+      rs.Set("links", st.first, "entries", st.second.first);
+      rs.Set("links", st.first, "bytes", st.second.second);
+    }
+    rs.Set("links", "total", "ranges", brl_.size());
+    rs.Set("links", "total", "bytes", mem_total);
+  }
+
 
   /// Pre- / postsolve loops over link entries
   /// and calls the link's method for each.
@@ -107,17 +141,73 @@ public:
   MVOverEl<ValType> \
     Presolve ## name ( \
       const MVOverEl<ValType> & mv) override { \
+    ScopedRunTimer timer(GetEnv().GetRunStats(), "presolve", #name); \
     return RunPresolve(&BasicLink::Presolve ## name, mv); \
   } \
   MVOverEl<ValType> \
     Postsolve ## name ( \
       const MVOverEl<ValType> & mv) override { \
+    ScopedRunTimer timer(GetEnv().GetRunStats(), "postsolve", #name); \
     return RunPostsolve(&BasicLink::Postsolve ## name, mv); \
   }
 
   LIST_PRESOLVE_METHODS
 
 
+  /// Postsolve several solutions, e.g., a solution pool.
+  /// The solutions are split between up to GetPostsolveThreads()
+  /// threads, each propagating its solutions
+  /// in its own value slot of every node.
+  /// Links are only read during postsolve, so the threads
+  /// share the conversion graph.
+  std::vector<ModelValuesDbl> PostsolveSolutions(
+      const std::vector<ModelValuesDbl>& mvs) override {
+    std::size_t num_threads = GetPostsolveThreads()>0 ?
+          GetPostsolveThreads() : std::thread::hardware_concurrency();
+    num_threads = std::min(num_threads, mvs.size());
+    ScopedRunTimer timer(GetEnv().GetRunStats(),
+                         "postsolve", "Solutions");
+    if (num_threads < 2)
+      return BasicValuePresolver::PostsolveSolutions(mvs);
+    for (const auto& mv: mvs)       // create any new target nodes now
+      CreateTargetNodes(mv);
+    for (auto pvn: val_nodes_)
+      pvn->ReserveSlots(num_threads);
+    std::vector<ModelValuesDbl> result(mvs.size());
+    auto postsolve = [this, &mvs, &result](
+        int slot, std::size_t beg, std::size_t end) {
+      ValueNode::CurrentSlot() = slot;
+      for (auto i=beg; i!=end; ++i)
+        result[i] = RunPostsolve(&BasicLink::PostsolveSolution, mvs[i]);
+      ValueNode::CurrentSlot() = 0;
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t t=1; t<num_threads; ++t)
+      threads.push_back(std::thread(postsolve, (int)t,
+                                    mvs.size() * t / num_threads,
+                                    mvs.size() * (t+1) / num_threads));
+    postsolve(0, 0, mvs.size() / num_threads);
+    for (auto& thr: threads)
+      thr.join();
+    for (auto pvn: val_nodes_)
+      pvn->ReleaseSlots();
+    return result;
+  }
+
+  /// Set number of threads for PostsolveSolutions().
+  /// 0: hardware concurrency
+  void SetPostsolveThreads(int n) { postsolve_threads_=n; }
+
+  /// Number of threads for PostsolveSolutions()
+  int GetPostsolveThreads() const { return postsolve_threads_; }
+
+  /// Check primal solution of the presolved model,
+  /// if a checker provided
+  void CheckPresolvedSolution(ArrayRef<double> x) override {
+    if (sc_)
+      sc_(x);
+  }
+
   /// Register a ValueNode*
   void Register(ValueNode* pvn) override {
     auto res = val_nodes_.insert(pvn).second;
@@ -130,11 +220,114 @@ public:
     assert(res);
   }
 
+  /// Register a link, in the order of construction
+  void RegisterLink(BasicLink* pl) { links_.push_back(pl); }
+
+  /// Deregister a link
+  void DeregisterLink(BasicLink* pl) {
+    auto it = std::find(links_.begin(), links_.end(), pl);
+    assert(links_.end() != it);
+    links_.erase(it);
+  }
+
+  /// Serialize the conversion graph:
+  /// terminal node keys, node sizes, link entries, and link ranges.
+  /// Nodes are identified by name.
+  /// @return false if node names are not unique
+  bool SerializeGraph(BinaryWriter& wrt) const {
+    SerializeTerminalKeys(wrt, src_);
+    SerializeTerminalKeys(wrt, dest_);
+    auto nodes = GetNodesByName();
+    BasicLink::NodeIds ids;
+    for (int i=0; i<(int)nodes.size(); ++i) {
+      if (i && nodes[i]->GetName() == nodes[i-1]->GetName())
+        return false;
+      ids[nodes[i]] = i;
+    }
+    SerializeSize(wrt, nodes.size());
+    for (auto pvn: nodes) {
+      Serialize(wrt, pvn->GetName());
+      SerializeSize(wrt, pvn->Size());
+    }
+    std::unordered_map<const BasicLink*, int> link_ids;
+    SerializeSize(wrt, links_.size());
+    for (int i=0; i<(int)links_.size(); ++i) {
+      link_ids[links_[i]] = i;
+      Serialize(wrt, std::string(links_[i]->GetTypeName()));
+      links_[i]->SerializeEntries(wrt, ids);
+    }
+    SerializeSize(wrt, brl_.size());
+    for (const auto& br: brl_) {
+      Serialize(wrt, link_ids.at(&br.b_));
+      Serialize(wrt, br.ir_.beg_);
+      Serialize(wrt, br.ir_.end_);
+    }
+    return true;
+  }
+
+  /// Restore the conversion graph written by SerializeGraph().
+  /// The nodes and links have to exist already,
+  /// except terminal nodes, which are created here
+  void DeserializeGraph(BinaryReader& rd) {
+    DeserializeTerminalKeys(rd, src_);
+    DeserializeTerminalKeys(rd, dest_);
+    std::unordered_map<std::string, ValueNode*> by_name;
+    for (auto pvn: val_nodes_)
+      by_name[pvn->GetName()] = pvn;
+    BasicLink::NodesById nodes(DeserializeSize(rd));
+    for (auto& pvn: nodes) {
+      auto name = Deserialize(rd, (std::string*)nullptr);
+      auto it = by_name.find(name);
+      if (by_name.end() == it)
+        MP_RAISE("Conversion graph data: unknown node " + name);
+      pvn = it->second;
+      if (auto sz = DeserializeSize(rd))
+        pvn->Select(0, (int)sz);
+    }
+    if (DeserializeSize(rd) != links_.size())
+      MP_RAISE("Conversion graph data: links do not match");
+    for (auto pl: links_) {
+      if (Deserialize(rd, (std::string*)nullptr) != pl->GetTypeName())
+        MP_RAISE("Conversion graph data: links do not match");
+      pl->DeserializeEntries(rd, nodes);
+    }
+    brl_.clear();
+    i_exported_ = 0;
+    auto n_rng = DeserializeSize(rd);
+    for (std::size_t i=0; i<n_rng; ++i) {
+      auto i_link = Deserialize(rd, (int*)nullptr);
+      if (i_link<0 || i_link>=(int)links_.size())
+        MP_RAISE("Conversion graph data: invalid link range");
+      auto beg = Deserialize(rd, (int*)nullptr);
+      auto end = Deserialize(rd, (int*)nullptr);
+      if (beg<0 || beg>=end || end>links_[i_link]->GetNumberOfEntries())
+        MP_RAISE("Conversion graph data: invalid link range");
+      brl_.Add( { *links_[i_link], {beg, end} } );
+    }
+  }
+
 
 protected:
   /// Helper type: virtual member function pointer
   using LinkFn = void (BasicLink::*)(LinkIndexRange);
 
+  /// Number of entries and their memory per link type.
+  /// @param mem_total: total memory incl. the link range list
+  std::map<std::string, std::pair<long, size_t> >
+  GetLinkStats(size_t& mem_total) const {
+    std::unordered_set<const BasicLink*> links;
+    std::map<std::string, std::pair<long, size_t> > stats;
+    mem_total = brl_.size() * sizeof(LinkRange);
+    for (const auto& br: brl_)
+      if (links.insert(&br.b_).second) {
+        auto& st = stats[br.b_.GetTypeName()];
+        st.first += br.b_.GetNumberOfEntries();
+        st.second += br.b_.GetEntriesMemory();
+        mem_total += br.b_.GetEntriesMemory();
+      }
+    return stats;
+  }
+
   /// Generic value presolve loop: forward
   template <class ModelValues>
   ModelValues RunPresolve(LinkFn fn, const ModelValues& mv) const {
@@ -156,6 +349,18 @@ protected:
     return src_;
   }
 
+  /// Make sure the target nodes have arrays
+  /// for all keys present in \a mv
+  template <class ModelValues>
+  void CreateTargetNodes(const ModelValues& mv) const {
+    for (const auto& vv: mv.GetVarValues().GetMap())
+      dest_.GetVarValues()(vv.first);
+    for (const auto& cv: mv.GetConValues().GetMap())
+      dest_.GetConValues()(cv.first);
+    for (const auto& ov: mv.GetObjValues().GetMap())
+      dest_.GetObjValues()(ov.first);
+  }
+
   /// Clean up value nodes for new propagation
   void CleanUpValueNodes() const {
     for (auto pvn: val_nodes_)
@@ -196,6 +401,42 @@ protected:
     }
   }
 
+  /// The value nodes, sorted by name
+  std::vector<const ValueNode*> GetNodesByName() const {
+    std::vector<const ValueNode*> nodes(val_nodes_.begin(), val_nodes_.end());
+    std::sort(nodes.begin(), nodes.end(),
+              [](const ValueNode* a, const ValueNode* b) {
+      return a->GetName() < b->GetName();
+    });
+    return nodes;
+  }
+
+  /// Serialize the keys and node names of terminal nodes
+  static void SerializeTerminalKeys(
+      BinaryWriter& wrt, const ModelValuesTerminal& mvt) {
+    for (const auto* pmap: { &mvt.GetVarValues(), &mvt.GetConValues(),
+         &mvt.GetObjValues() }) {
+      SerializeSize(wrt, pmap->GetMap().size());
+      for (const auto& nd: pmap->GetMap()) {
+        Serialize(wrt, nd.first);
+        Serialize(wrt, nd.second.GetName());
+      }
+    }
+  }
+
+  /// Create terminal nodes written by SerializeTerminalKeys()
+  static void DeserializeTerminalKeys(
+      BinaryReader& rd, ModelValuesTerminal& mvt) {
+    for (auto* pmap: { &mvt.GetVarValues(), &mvt.GetConValues(),
+         &mvt.GetObjValues() }) {
+      auto n = DeserializeSize(rd);
+      for (std::size_t i=0; i<n; ++i) {
+        auto key = Deserialize(rd, (int*)nullptr);
+        (*pmap)(key).SetName(Deserialize(rd, (std::string*)nullptr));
+      }
+    }
+  }
+
   /// Write a vector of nodes
   void WriteNodes(fmt::MemoryWriter& wrt, const std::vector<NodeRange>& nodes) {
     for (size_t i=0; i<nodes.size(); ++i) {
@@ -223,6 +464,9 @@ private:
     src_{*this, "src"},
     dest_{*this, "dest"};
 
+  /// The links, in the order of construction
+  std::vector<BasicLink*> links_;
+
   /// The link ranges
   LinkRangeList brl_;
 
@@ -232,6 +476,12 @@ private:
   /// Exporter functor
   ExporterFn const bts_{};
 
+  /// Solution checker functor
+  SolCheckerFn const sc_{};
+
+  /// Number of threads for PostsolveSolutions()
+  int postsolve_threads_=1;
+
   /// 1-after-last exported entry
   int i_exported_=0;
 
@@ -240,6 +490,16 @@ private:
 };
 
 
+/// Implement link registration in global Presolver
+inline
+BasicLink::BasicLink(ValuePresolver& pre) : value_presolver_(pre)
+{ value_presolver_.RegisterLink(this); }
+
+/// Implement link deregistration in global Presolver
+inline
+BasicLink::~BasicLink()
+{ value_presolver_.DeregisterLink(this); }
+
 /// Implement link range registration in global Presolver
 inline void
 BasicLink::RegisterLinkIndexRange(LinkIndexRange bir)
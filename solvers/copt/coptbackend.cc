@@ -244,15 +244,17 @@ void CoptBackend::ReportCOPTPool() {
     return;
   int iPoolSolution = -1;
   int nsolutions;
-  
+  std::vector<pre::ModelValuesDbl> pool;
   while (++iPoolSolution < getIntAttr(COPT_INTATTR_POOLSOLS)) {
-    auto mv = GetValuePresolver().PostsolveSolution(  // only single-objective with pool
+    pool.push_back(                         // only single-objective with pool
           { { getPoolSolution(iPoolSolution) },
             {},                                       // no duals
             std::vector<double>{ getPoolObjective(iPoolSolution) } } );
+  }
+  auto mvs = GetValuePresolver().PostsolveSolutions(pool);
+  for (auto& mv: mvs)
     ReportIntermediateSolution(
           { mv.GetVarValues()(), mv.GetConValues()(), mv.GetObjValues()() });
-  }
 }
 
 
@@ -972,16 +972,19 @@ void GurobiBackend::ReportGurobiPool() {
   if (!IsMIP())         // Gurobi 9.1.2 returns 1 solution for LP
     return;             // but cannot retrieve its pool attributes
   int iPoolSolution = -1;
+  std::vector<pre::ModelValuesDbl> pool;
   while (++iPoolSolution < GrbGetIntAttr(GRB_INT_ATTR_SOLCOUNT)) {
     GrbSetIntParam(GRB_INT_PAR_SOLUTIONNUMBER, iPoolSolution);
-    auto mv = GetValuePresolver().PostsolveSolution(  // only single-obj with pool
+    pool.push_back(                                   // only single-obj with pool
           { { CurrentGrbPoolPrimalSolution() },
             {},                                       // no duals
             std::vector<double>{ CurrentGrbPoolObjectiveValue() } } );
+  }
+  auto mvs = GetValuePresolver().PostsolveSolutions(pool);
+  for (auto& mv: mvs)
     ReportIntermediateSolution(
           { mv.GetVarValues()(), mv.GetConValues()(),
             mv.GetObjValues()() });   // not when multiobj
-  }
 }
 
 void GurobiBackend::ConsiderGurobiFixedModel() {
@@ -71,27 +71,12 @@ void HighsModelAPI::SetQuadraticObjective(int iobj, const QuadraticObjective& qo
   }
 }
 
-void HighsModelAPI::AddConstraint(const LinConRange& lc) {
-  AccConstraints.add(lc);
-}
-void HighsModelAPI::AddConstraint(const LinConLE& lc) {
-  AccConstraints.add(lc);
-}
-void HighsModelAPI::AddConstraint(const LinConEQ& lc) {
-  AccConstraints.add(lc);
-}
-void HighsModelAPI::AddConstraint(const LinConGE& lc) {
-  AccConstraints.add(lc);
-}
-
-void HighsModelAPI::FinishProblemModificationPhase() {
+void HighsModelAPI::AddLinearConstraints(const LinConBlock& lcb) {
   HIGHS_CCALL(Highs_addRows(lp(),
-    AccConstraints.lb.size(),
-    AccConstraints.lb.data(),
-    AccConstraints.ub.data(),
-    AccConstraints.coeffs.size(),
-    AccConstraints.starts.data(),
-    AccConstraints.indices.data(),
-    AccConstraints.coeffs.data()));
+    lcb.size(), lcb.plb(), lcb.pub(),
+    lcb.num_nz(), lcb.pstarts(), lcb.pvars(), lcb.pcoefs()));
 }
+
+void HighsModelAPI::FinishProblemModificationPhase() { }
+
 } // namespace mp
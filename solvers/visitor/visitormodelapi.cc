@@ -65,6 +65,23 @@ void VisitorModelAPI::SetQuadraticObjective(int iobj, const QuadraticObjective&
   }
 }
 
+void VisitorModelAPI::UpdateVarBounds(const std::vector<int>& vars,
+                                      const std::vector<double>& lbs,
+                                      const std::vector<double>& ubs) {
+  fmt::format("Updating bounds of {} variables.\n", vars.size());
+  /* VISITOR_CCALL(VISITOR_ChgColBounds(lp(), vars.size(),
+                        vars.data(), lbs.data(), ubs.data()) ); */
+}
+
+void VisitorModelAPI::UpdateLinConRanges(const std::vector<int>& cons,
+                                         const std::vector<double>& lbs,
+                                         const std::vector<double>& ubs) {
+  fmt::format("Updating bounds of {} linear range constraints.\n",
+              cons.size());
+  /* VISITOR_CCALL(VISITOR_ChgRowBounds(lp(), cons.size(),
+                        cons.data(), lbs.data(), ubs.data()) ); */
+}
+
 void VisitorModelAPI::AddConstraint(const LinConRange& lc) {
   fmt::print("Adding range linear constraint {}\n", lc.name());
   fmt::print("{} <=", lc.lb());
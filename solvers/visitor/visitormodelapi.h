@@ -40,6 +40,17 @@ public:
   static int AcceptsQuadObj() { return 0; }
   void SetQuadraticObjective(int iobj, const QuadraticObjective& qo);
 
+  /// Persistent mode (option tech:persistent):
+  /// if the solver can modify a model in place,
+  /// changed bounds and objectives are passed here
+  static constexpr bool AcceptsModelUpdates() { return true; }
+  void UpdateVarBounds(const std::vector<int>& vars,
+                       const std::vector<double>& lbs,
+                       const std::vector<double>& ubs);
+  void UpdateLinConRanges(const std::vector<int>& cons,
+                          const std::vector<double>& lbs,
+                          const std::vector<double>& ubs);
+
   //////////////////////////// GENERAL CONSTRAINTS ////////////////////////////
   USE_BASE_CONSTRAINT_HANDLERS(BaseModelAPI)
 
@@ -24,7 +24,9 @@
 #include "mp/expr-visitor.h"
 #include "expr-writer.h"
 
+#include <cstdlib>
 #include <cstring>
+#include <new>
 
 using mp::Cast;
 
@@ -144,6 +146,37 @@ void mp::format(fmt::BasicFormatter<char> &f, const char *&, NumericExpr e) {
   f.writer() << fmt::StringRef(writer.data(), writer.size());
 }
 
+char *mp::ArenaAllocator::AllocateBlock(std::size_t size) {
+  std::size_t header_size = Align(sizeof(Block));
+  // Large objects get blocks of their own so that the rest
+  // of the current block is not wasted.
+  bool dedicated = size > next_block_size_ / 4;
+  std::size_t block_size = dedicated ? size : next_block_size_;
+  Block *block = static_cast<Block*>(std::malloc(header_size + block_size));
+  if (!block)
+    throw std::bad_alloc();
+  block->next = blocks_;
+  block->size = block_size;
+  blocks_ = block;
+  allocated_ += header_size + block_size;
+  char *result = reinterpret_cast<char*>(block) + header_size;
+  if (dedicated)
+    return result;
+  if (next_block_size_ < MAX_BLOCK_SIZE)
+    next_block_size_ *= 2;
+  ptr_ = result + size;
+  end_ = result + block_size;
+  return result;
+}
+
+mp::ArenaAllocator::~ArenaAllocator() {
+  while (blocks_) {
+    Block *next = blocks_->next;
+    std::free(blocks_);
+    blocks_ = next;
+  }
+}
+
 bool mp::Equal(Expr e1, Expr e2) {
   if (e1.kind() != e2.kind())
     return false;
@@ -303,4 +303,5 @@ void mp::internal::NLFileReader<File>::Read(
 }
 
 template class mp::internal::TextReader<>;
+template class mp::internal::TextReader<mp::internal::Locale>;
 template class mp::internal::NLFileReader<>;
@@ -21,18 +21,47 @@
  */
 
 #include <map>
+#include <new>
 
 #include "mp/problem.h"
 #include "mp/problem-builder.h"
 
 namespace mp {
 
+void LinearExpr::Reallocate(int capacity) {
+  assert(capacity >= num_terms_);
+  if (capacity == 0) {
+    Free();
+    vars_ = 0;
+    coefs_ = 0;
+    capacity_ = 0;
+    return;
+  }
+  // Coefficients and variable indices share one allocation,
+  // coefficients go first for alignment.
+  std::size_t size = val(SafeInt<std::size_t>(capacity) *
+                         (sizeof(double) + sizeof(int)));
+  double *coefs = static_cast<double*>(std::malloc(size));
+  if (!coefs)
+    throw std::bad_alloc();
+  int *vars = reinterpret_cast<int*>(coefs + capacity);
+  if (num_terms_ != 0) {
+    std::memcpy(coefs, coefs_, num_terms_ * sizeof(double));
+    std::memcpy(vars, vars_, num_terms_ * sizeof(int));
+  }
+  Free();
+  coefs_ = coefs;
+  vars_ = vars;
+  capacity_ = capacity;
+}
+
 void LinearExpr::SortTerms() {
   std::map<int, double> var_coef_map;
   for (int i=0; i<num_terms(); ++i)
     if (0.0!=std::fabs(coef(i)))
       var_coef_map[var_index(i)] += coef(i);
-  terms_.clear();
+  MakeOwned();
+  num_terms_ = 0;
   for (const auto& vc: var_coef_map) {
     if (0.0!=std::fabs(vc.second))
       AddTerm(vc.first, vc.second);
@@ -111,8 +140,92 @@ void BasicProblem<Alloc>::SetInfo(const ProblemInfo &info) {
   nonlinear_exprs_.reserve(num_common_exprs);
 }
 
+template <typename Alloc>
+bool BasicProblem<Alloc>::is_linear() const {
+  for (const auto& e: nonlinear_objs_)
+    if (e)
+      return false;
+  for (const auto& e: nonlinear_cons_)
+    if (e)
+      return false;
+  return logical_cons_.empty() && linear_exprs_.empty() &&
+      !HasComplementarity();
+}
+
+namespace {
+bool SameVars(const LinearExpr &e1, const LinearExpr &e2) {
+  if (e1.num_terms() != e2.num_terms())
+    return false;
+  for (int i = 0; i < e1.num_terms(); ++i)
+    if (e1.var_index(i) != e2.var_index(i))
+      return false;
+  return true;
+}
+
+bool SameCoefs(const LinearExpr &e1, const LinearExpr &e2) {
+  for (int i = 0; i < e1.num_terms(); ++i)
+    if (e1.coef(i) != e2.coef(i))
+      return false;
+  return true;
+}
+}  // namespace
+
+template <typename Alloc>
+ProblemDiff BasicProblem<Alloc>::Compare(const BasicProblem &other) const {
+  ProblemDiff diff;
+  if (!is_linear() || !other.is_linear() ||
+      num_vars() != other.num_vars() ||
+      num_objs() != other.num_objs() ||
+      num_algebraic_cons() != other.num_algebraic_cons() ||
+      is_var_int_ != other.is_var_int_ ||
+      is_obj_max_ != other.is_obj_max_)
+    return diff;
+  for (int i = 0, n = num_objs(); i < n; ++i) {
+    if (!SameVars(linear_objs_[i], other.linear_objs_[i]))
+      return diff;
+    if (!SameCoefs(linear_objs_[i], other.linear_objs_[i]))
+      diff.objs.push_back(i);
+  }
+  for (int i = 0, n = num_algebraic_cons(); i < n; ++i) {
+    const auto &con = algebraic_cons_[i], &other_con = other.algebraic_cons_[i];
+    if (!SameVars(con.linear_expr, other_con.linear_expr) ||
+        !SameCoefs(con.linear_expr, other_con.linear_expr))
+      return diff;
+    if (con.lb != other_con.lb || con.ub != other_con.ub)
+      diff.alg_cons.push_back(i);
+  }
+  for (int i = 0, n = num_vars(); i < n; ++i) {
+    if (vars_[i].lb != other.vars_[i].lb || vars_[i].ub != other.vars_[i].ub)
+      diff.vars.push_back(i);
+  }
+  diff.same_structure = true;
+  return diff;
+}
+
+template <typename Alloc>
+void BasicProblem<Alloc>::Update(
+    BasicProblem &other, const ProblemDiff &diff) {
+  MP_ASSERT(diff.same_structure, "cannot update a different structure");
+  for (int i: diff.vars)
+    vars_[i] = other.vars_[i];
+  for (int i: diff.alg_cons) {
+    algebraic_cons_[i].lb = other.algebraic_cons_[i].lb;
+    algebraic_cons_[i].ub = other.algebraic_cons_[i].ub;
+  }
+  for (int i: diff.objs) {
+    auto &expr = linear_objs_[i];
+    const auto &other_expr = other.linear_objs_[i];
+    for (int k = 0; k < expr.num_terms(); ++k)
+      expr.set_coef(k, other_expr.coef(k));
+  }
+  initial_values_.swap(other.initial_values_);
+  initial_dual_values_.swap(other.initial_dual_values_);
+  SwapSuffixes(other);
+}
+
 /// Instantiate
 template class BasicProblem< >;
+template class BasicProblem< BasicProblemParams<ArenaAllocator> >;
 
 template void ReadNLFile(fmt::CStringRef filename, Problem &p, int flags);
 
@@ -40,3 +40,29 @@ void mp::internal::WriteMessage(fmt::BufferedFile &file, const char *message) {
   }
   std::fputc('\n', file.get());
 }
+
+void mp::internal::WriteBinaryRecord(
+    fmt::BufferedFile &file, const void *data, int size) {
+  std::fwrite(&size, sizeof(size), 1, file.get());
+  if (size)
+    std::fwrite(data, 1, size, file.get());
+  std::fwrite(&size, sizeof(size), 1, file.get());
+}
+
+void mp::internal::WriteBinaryMessage(
+    fmt::BufferedFile &file, const char *message) {
+  for (const char *line_start = message; *line_start; ) {
+    const char *line_end = line_start;
+    while (*line_end && *line_end != '\n')
+      ++line_end;
+    // An empty record indicates the end of message
+    if (line_end == line_start)
+      WriteBinaryRecord(file, " ", 1);
+    else
+      WriteBinaryRecord(file, line_start, (int)(line_end - line_start));
+    if (!*line_end)
+      break;
+    line_start = line_end + 1;
+  }
+  WriteBinaryRecord(file, "", 0);
+}
@@ -637,6 +637,18 @@ void BasicSolver::InitMetaInfoAndOptions(
         "| 8 - Suppress solution message.",
         &Solver::GetWantSol, &Solver::SetWantSol);
 
+  AddIntOption(
+        "sol:binary solbinary",
+        "Format of the ``.sol`` file:\n"
+        "\n"
+        "| 0 - Text (default)\n"
+        "| 1 - Binary\n"
+        "| 2 - Binary if the ``.nl`` file is binary, otherwise text.\n"
+        "\n"
+        "Binary ``.sol`` files are faster to write and read back "
+        "for large solutions.",
+        &Solver::GetSolBinary, &Solver::SetSolBinary);
+
   AddIntOption(
         "obj:no objno",
         "Objective to optimize:\n"
@@ -675,6 +687,13 @@ void BasicSolver::InitMetaInfoAndOptions(
   AddOption(OptionPtr(new BoolOption(timing_, "tech:timing timing",
       "0*/1: Whether to display timings for the run.")));
 
+  AddStrOption("tech:timing:json",
+      "Name of a file to write run statistics to, as JSON: "
+      "timings and counters of the phases "
+      "(NL read, conversion, pushing the model to the solver, "
+      "postsolve) and of the individual constraint converters.",
+      &Solver::GetRunStatsFile, &Solver::SetRunStatsFile);
+
   if ((flags & MULTIPLE_SOL) != 0) {
 
     AddOption(OptionPtr(new BoolOption(count_solutions_, "sol:count countsolutions",
@@ -741,6 +760,17 @@ void BasicSolver::PrintWarnings() {
   }
 }
 
+void BasicSolver::WriteRunStats() {
+  if (run_stats_file_.empty())
+    return;
+  fmt::MemoryWriter wrt;
+  run_stats_.WriteJSON(wrt);
+  if (!WriteStringToFile(run_stats_file_, wrt.str()))
+    AddWarning("tech:timing:json",
+               "Could not write run statistics to '"
+               + run_stats_file_ + "'");
+}
+
 std::string BasicSolver::ToString(
     const WarningsMap::value_type& wrn) {
   return fmt::format(
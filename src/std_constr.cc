@@ -1,4 +1,7 @@
-#include <map>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 #include "mp/flat/expr_quadratic.h"
 
@@ -6,19 +9,67 @@
 
 namespace mp {
 
+namespace {
+
+/// A nonzero term being canonicalized:
+/// variable(s), position in the expression, coefficient.
+/// Ordering by (key, position) makes std::sort stable, so
+/// duplicates are summed in their original order
+template <class Key>
+struct SortedTerm {
+  Key key_;
+  int pos_;
+  double coef_;
+
+  bool operator<(const SortedTerm& t) const
+  { return key_<t.key_ || (key_==t.key_ && pos_<t.pos_); }
+};
+
+/// Scratch space reused by sort_terms(), one per thread
+template <class Key>
+std::vector< SortedTerm<Key> >& GetSortScratch() {
+  static thread_local std::vector< SortedTerm<Key> > terms;
+  return terms;
+}
+
+/// Sort the terms and sum up duplicates in place
+/// @return number of distinct keys
+template <class Key>
+std::size_t SortAndMergeTerms(std::vector< SortedTerm<Key> >& terms) {
+  std::sort(terms.begin(), terms.end());
+  std::size_t n_unique = 0;
+  for (std::size_t k=0; k<terms.size(); ++k) {
+    if (n_unique && terms[n_unique-1].key_==terms[k].key_)
+      terms[n_unique-1].coef_ += terms[k].coef_;
+    else
+      terms[n_unique++] = terms[k];
+  }
+  return n_unique;
+}
+
+} // namespace
+
 void LinTerms::sort_terms(bool force_sort) {
-  std::map<int, double> var_coef_map;
+  bool is_canonical = true;            // sorted, no duplicates or 0's
+  for (size_t i=0; i<size() && is_canonical; ++i)
+    is_canonical = 0.0!=std::fabs(coefs_[i]) &&
+        (!i || vars_[i-1]<vars_[i]);
+  if (is_canonical)
+    return;
+  auto& terms = GetSortScratch<int>();
+  terms.clear();
   for (size_t i=0; i<size(); ++i)
     if (0.0!=std::fabs(coefs_[i]))
-      var_coef_map[vars_[i]] += coefs_[i];
+      terms.push_back( { vars_[i], (int)i, coefs_[i] } );
+  const auto n_unique = SortAndMergeTerms(terms);
   if (force_sort ||                    // force sorting for tests
-      var_coef_map.size() < size()) {
+      n_unique < size()) {
     coefs_.clear();
     vars_.clear();
-    for (const auto& vc: var_coef_map) {
-      if (0.0!=std::fabs(vc.second)) {         // Need tolerance?
-        coefs_.push_back(vc.second);
-        vars_.push_back(vc.first);
+    for (size_t k=0; k<n_unique; ++k) {
+      if (0.0!=std::fabs(terms[k].coef_)) {    // Need tolerance?
+        coefs_.push_back(terms[k].coef_);
+        vars_.push_back(terms[k].key_);
       }
     }
   }
@@ -29,18 +80,19 @@ void QuadTerms::sort_terms()  {
   auto sort_pair = [](int a, int b) {
     return a<b ? std::pair<int, int>(a, b) : std::pair<int, int>(b, a);
   };
-  std::map<std::pair<int, int>, double> var_coef_map;
+  auto& terms = GetSortScratch< std::pair<int, int> >();
+  terms.clear();
   for (size_t i=0; i<size(); ++i)
     if (0.0!=std::fabs(coefs_[i]))
-      var_coef_map[sort_pair(vars1_[i], vars2_[i])] += coefs_[i];
-  if (true) {
-    coefs_.clear();
-    vars1_.clear();
-    vars2_.clear();
-    for (const auto& vc: var_coef_map) {
-      if (0.0!=std::fabs(vc.second))         // Need tolerance?
-        add_term(vc.second, vc.first.first, vc.first.second);
-    }
+      terms.push_back( { sort_pair(vars1_[i], vars2_[i]),
+                         (int)i, coefs_[i] } );
+  const auto n_unique = SortAndMergeTerms(terms);
+  coefs_.clear();
+  vars1_.clear();
+  vars2_.clear();
+  for (size_t k=0; k<n_unique; ++k) {
+    if (0.0!=std::fabs(terms[k].coef_))        // Need tolerance?
+      add_term(terms[k].coef_, terms[k].key_.first, terms[k].key_.second);
   }
 }
 
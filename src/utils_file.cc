@@ -24,6 +24,8 @@
 #include <algorithm>
 #include <cctype>
 #include <fstream>
+#include <sstream>
+#include <cstdio>
 
 #include "mp/utils-file.h"
 
@@ -58,4 +60,29 @@ std::unique_ptr<BasicFileAppender> MakeFileAppender() {
   { new FileAppender__fstream() };
 }
 
+bool ReadFileToString(const std::string& fln, std::string& s) {
+  std::ifstream ifs(fln, std::ios::in | std::ios::binary);
+  if (!ifs)
+    return false;
+  std::ostringstream oss;
+  oss << ifs.rdbuf();
+  s = oss.str();
+  return !ifs.bad();
+}
+
+bool WriteStringToFile(const std::string& fln, const std::string& s) {
+  std::string fln_tmp = fln + ".tmp";
+  {
+    std::ofstream ofs(fln_tmp,
+                      std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!ofs.write(s.data(), s.size()))
+      return false;
+  }
+  if (std::rename(fln_tmp.c_str(), fln.c_str())) {
+    std::remove(fln_tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
 }  // namespace mp
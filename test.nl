@@ -0,0 +1,20 @@
+g0
+ 5 7 6 0 0 8
+ 0 0 0 0 0 0
+ 0 0
+ 0 0 0
+ 0 9 0 0
+ 0 0 0 0 0
+ 0 0
+ 0 0
+ 0 0 1 0 0
+b
+1 0
+1 0
+1 0
+1 0
+1 0
+O0 0
+o2
+v0
+v0
@@ -1,4 +1,8 @@
 
+#include <deque>
+#include <algorithm>
+#include <cstdio>
+
 #include "mp/easy-modeler.h"
 
 #include "converter-flat-test.h"
@@ -67,4 +71,670 @@ TEST_F(InterfaceTester_QuadraticConstraint, QuadConstraintIsPassedToBackend__Old
     {5.0, 5.0} ) );
 }
 
+
+/////////////////////////////// Subexpression maps ////////////////////////////
+struct MapRegistry {
+  std::vector<const mp::BasicConstraintMap*> maps_;
+  void AddConstraintMap(const mp::BasicConstraintMap& cm)
+  { maps_.push_back(&cm); }
+};
+
+TEST(ConstraintMapTest, FindInsert) {
+  MapRegistry reg;
+  mp::ConstraintMap<mp::MaxConstraint> map(reg, "MaxConstraint");
+  ASSERT_EQ(1u, reg.maps_.size());
+  EXPECT_STREQ("MaxConstraint", reg.maps_[0]->GetName());
+  std::deque<mp::MaxConstraint> cons;
+  for (int i=0; i<1000; ++i)
+    cons.push_back(mp::MaxConstraint(i, { i, i+1, 2*i }));
+  EXPECT_EQ(-1, map.Find(cons[0]));
+  for (int i=0; i<1000; ++i)
+    EXPECT_TRUE(map.Insert(cons[i], i));
+  EXPECT_EQ(1000u, map.size());
+  EXPECT_FALSE(map.Insert(mp::MaxConstraint(5, { 5, 6, 10 }), 1000));
+  for (int i=0; i<1000; ++i) {
+    // Result variable is not part of the key
+    EXPECT_EQ(i, map.Find(mp::MaxConstraint(-1, { i, i+1, 2*i })));
+    EXPECT_EQ(-1, map.Find(mp::MaxConstraint(i, { i, i+2, 2*i })));
+  }
+  const auto& st = map.GetStats();
+  EXPECT_EQ(2001u, st.n_find_);
+  EXPECT_EQ(1000u, st.n_hit_);
+  EXPECT_EQ(3002u, st.n_access_);
+  EXPECT_GE(st.n_probe_, 3001u);
+  EXPECT_GE(st.max_probe_, 1u);
+  // Load factor is at most 1/2
+  EXPECT_LT(double(st.n_probe_) / st.n_access_, 3.0);
+}
+
+
+/////////////////////////////// Conversion worklist ///////////////////////////
+TEST(ConstraintKeeperWorklistTest, PopsPendingByPriority) {
+  mp::ConstraintKeeperWorklist wl;
+  const int s0 = wl.Register(2.0), s1 = wl.Register(0.5),
+      s2 = wl.Register(1.0);
+  EXPECT_TRUE(wl.empty());
+  wl.Push(s0);
+  wl.Push(s2);
+  wl.Push(s0);                    // already pending
+  ASSERT_FALSE(wl.empty());
+  EXPECT_EQ(s2, wl.Pop());
+  wl.Push(s1);
+  wl.Push(s2);                    // pending until Done()
+  EXPECT_EQ(s1, wl.Pop());
+  wl.Done(s1);
+  wl.Done(s2);
+  EXPECT_EQ(s0, wl.Pop());
+  EXPECT_TRUE(wl.empty());
+  wl.Push(s2);                    // pending again after Done()
+  EXPECT_EQ(s2, wl.Pop());
+  EXPECT_TRUE(wl.empty());
+}
+
+
+/////////////////////////////// Linear constraint blocks //////////////////////
+/// A backend receiving linear constraints in blocks
+class LinConBlockBackend : public mp::BasicFlatModelAPI {
+public:
+  LinConBlockBackend(mp::Env& ) { }
+
+  static constexpr const char* GetTypeName() { return "LinConBlock tester"; }
+
+  void AddVariables(const mp::VarArrayDef& ) { }
+
+  USE_BASE_CONSTRAINT_HANDLERS(mp::BasicFlatModelAPI)
+  ACCEPT_CONSTRAINT(mp::LinConRange, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConLE, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConEQ, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConGE, mp::Recommended, mp::CG_Linear)
+
+  static constexpr bool AcceptsLinConBlocks() { return true; }
+  void AddLinearConstraints(const mp::LinConBlock& lcb) {
+    std::string block;
+    for (int i=0; i<lcb.size(); ++i) {
+      block += fmt::format("{} <=", lcb.plb()[i]);
+      for (int k=lcb.pstarts()[i]; k<lcb.pstarts()[i+1]; ++k)
+        block += fmt::format(" {}*x{}", lcb.pcoefs()[k], lcb.pvars()[k]);
+      block += fmt::format(" <= {}; ", lcb.pub()[i]);
+    }
+    blocks_.push_back(block);
+  }
+
+  std::vector<std::string> blocks_;
+};
+
+TEST(LinConBlockTest, KeepersPassLinearConstraintsInBlocks) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::FlatConverter, LinConBlockBackend> >;
+  mp::Env env;
+  Interface interface(env);
+  interface.InitOptions();
+  auto& p = interface.GetModel();
+  p.AddVars(3, 0.0, 10.0);
+  auto le1 = p.AddCon(-INFINITY, 5.0).set_linear_expr(2);
+  le1.AddTerm(0, 1.0);
+  le1.AddTerm(1, 2.0);
+  auto eq = p.AddCon(3.0, 3.0).set_linear_expr(2);
+  eq.AddTerm(1, 1.0);
+  eq.AddTerm(2, -1.0);
+  auto le2 = p.AddCon(-INFINITY, 7.0).set_linear_expr(2);
+  le2.AddTerm(0, 3.0);
+  le2.AddTerm(2, 1.0);
+  interface.ConvertModel();
+  const auto& blocks = interface.GetFlatCvt().GetModelAPI().blocks_;
+  // The flattener produces range constraints: a single keeper
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_EQ("-inf <= 1*x0 2*x1 <= 5; 3 <= 1*x1 -1*x2 <= 3; "
+            "-inf <= 3*x0 1*x2 <= 7; ", blocks[0]);
+}
+
+
+/////////////////////////////// Iterative expression walk ////////////////////
+/// A 10^6-deep chain x_{k%2} +/- (...(x2)...) in a constraint body
+/// is flattened into a single linear constraint
+TEST(ExprWalkTest, DeepChainIsFlattenedWithoutRecursion) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::FlatConverter, LinConBlockBackend> >;
+  mp::Env env;
+  Interface interface(env);
+  interface.InitOptions();
+  auto& p = interface.GetModel();
+  p.AddVars(3, 0.0, 10.0);
+  mp::NumericExpr e = p.MakeVariable(2);
+  double coefs[3] = {0.0, 0.0, 1.0};
+  const int depth = 1000000;
+  for (int k=0; k<depth; ++k) {
+    if (k%3) {
+      e = p.MakeBinary(mp::expr::ADD, p.MakeVariable(k%2), e);
+    } else {                              // x - (-(...)) == x + (...)
+      e = p.MakeBinary(mp::expr::SUB, p.MakeVariable(k%2),
+                       p.MakeUnary(mp::expr::MINUS, e));
+    }
+    coefs[k%2] += 1.0;
+  }
+  auto con = p.AddCon(-INFINITY, 5.0);
+  con.set_nonlinear_expr(e);
+  interface.ConvertModel();
+  const auto& blocks = interface.GetFlatCvt().GetModelAPI().blocks_;
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_EQ(fmt::format("-inf <= {}*x0 {}*x1 {}*x2 <= 5; ",
+                        coefs[0], coefs[1], coefs[2]), blocks[0]);
+}
+
+
+/// A 10^6-term sum of c*x[i%3] and constants
+/// is accumulated into a single linear constraint
+TEST(ExprWalkTest, LongSumOfProductsIsAccumulated) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::FlatConverter, LinConBlockBackend> >;
+  mp::Env env;
+  Interface interface(env);
+  interface.InitOptions();
+  auto& p = interface.GetModel();
+  p.AddVars(3, 0.0, 10.0);
+  const int n_args = 1000000;
+  auto sum = p.BeginSum(n_args);
+  double coefs[3] = {0.0, 0.0, 0.0};
+  double rhs = 5.0;
+  for (int i=0; i<n_args; ++i) {
+    if (i%1000) {
+      double c = i%5 + 1;
+      sum.AddArg(p.MakeBinary(mp::expr::MUL,
+                              p.MakeNumericConstant(c), p.MakeVariable(i%3)));
+      coefs[i%3] += c;
+    } else {
+      sum.AddArg(p.MakeNumericConstant(1.0));
+      rhs -= 1.0;
+    }
+  }
+  auto con = p.AddCon(-INFINITY, 5.0);
+  con.set_nonlinear_expr(p.EndSum(sum));
+  interface.ConvertModel();
+  const auto& blocks = interface.GetFlatCvt().GetModelAPI().blocks_;
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_EQ(fmt::format("-inf <= {}*x0 {}*x1 {}*x2 <= {}; ",
+                        coefs[0], coefs[1], coefs[2], rhs), blocks[0]);
+}
+
+TEST(LinTermsAccumulatorTest, SumsUpInPlaceAndResets) {
+  mp::LinTermsAccumulator acc;
+  EXPECT_TRUE(acc.empty());
+  acc.add_term(4.0, 7);
+  acc.add(mp::LinTerms({1.0, 3.0, -2.0}, {3, 1, 7}), 2.0);
+  mp::LinTerms lt;
+  acc.MoveOut(lt);                            // x7 cancels out
+  EXPECT_EQ(mp::LinTerms({6.0, 2.0}, {1, 3}), lt);
+  EXPECT_TRUE(acc.empty());
+  acc.add_term(1.0, 3);
+  acc.add_term(4.0, 1000);
+  mp::LinTerms lt2;
+  acc.MoveOut(lt2);                           // few touched: sorted list
+  EXPECT_EQ(mp::LinTerms({1.0, 4.0}, {3, 1000}), lt2);
+  acc.add_term(1.0, 5);
+  acc.clear();
+  EXPECT_TRUE(acc.empty());
+  mp::LinTerms lt3;
+  acc.MoveOut(lt3);
+  EXPECT_TRUE(lt3.empty());
+}
+
+
+/////////////////////////////// In-place model updates ///////////////////////
+/// A backend recording model updates
+class UpdatingBackend : public LinConBlockBackend {
+public:
+  UpdatingBackend(mp::Env& e) : LinConBlockBackend(e) { }
+
+  void SetLinearObjective(int i, const mp::LinearObjective& lo) {
+    objs_.push_back(fmt::format("{}: {} terms, coef0={}",
+                                i, lo.num_terms(), lo.coefs()[0]));
+  }
+
+  static constexpr bool AcceptsModelUpdates() { return true; }
+  void UpdateVarBounds(const std::vector<int>& vars,
+                       const std::vector<double>& lbs,
+                       const std::vector<double>& ubs) {
+    for (size_t k=0; k<vars.size(); ++k)
+      updates_.push_back(fmt::format("x{}: [{}, {}]", vars[k], lbs[k], ubs[k]));
+  }
+  void UpdateLinConRanges(const std::vector<int>& cons,
+                          const std::vector<double>& lbs,
+                          const std::vector<double>& ubs) {
+    for (size_t k=0; k<cons.size(); ++k)
+      updates_.push_back(fmt::format("c{}: [{}, {}]", cons[k], lbs[k], ubs[k]));
+  }
+
+  std::vector<std::string> objs_, updates_;
+};
+
+/// Build a small LP, parameterized by some bounds and coefficients
+void BuildUpdateTestLP(mp::Problem& p,
+                       double ub1, double rhs1, double objcoef0,
+                       double concoef = 2.0) {
+  p.AddVars(2, 0.0, 10.0);
+  p.var(1).set_ub(ub1);
+  auto obj = p.AddObj(mp::obj::MIN, 2);
+  obj.AddTerm(0, objcoef0);
+  obj.AddTerm(1, 1.0);
+  auto le = p.AddCon(-INFINITY, rhs1).set_linear_expr(2);
+  le.AddTerm(0, 1.0);
+  le.AddTerm(1, concoef);
+  auto ge = p.AddCon(1.0, INFINITY).set_linear_expr(1);
+  ge.AddTerm(0, 1.0);
+}
+
+TEST(ModelUpdateTest, UpdateBoundsAndObjectiveInPlace) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::FlatConverter, UpdatingBackend> >;
+  mp::Env env;
+  Interface interface(env);
+  interface.InitOptions();
+  BuildUpdateTestLP(interface.GetModel(), 10.0, 5.0, 1.0);
+  interface.ConvertModel();
+  const auto& be = interface.GetFlatCvt().GetModelAPI();
+  ASSERT_EQ(1u, be.objs_.size());
+  mp::Problem p2;
+  BuildUpdateTestLP(p2, 8.0, 6.0, 1.0);
+  EXPECT_TRUE(interface.UpdateModel(p2));
+  EXPECT_EQ((std::vector<std::string>{ "x1: [0, 8]", "c0: [-inf, 6]" }),
+            be.updates_);
+  EXPECT_EQ(1u, be.objs_.size());              // objective unchanged
+  EXPECT_EQ(8.0, interface.GetModel().var(1).ub());
+  EXPECT_EQ(6.0, interface.GetModel().algebraic_con(0).ub());
+  mp::Problem p3;
+  BuildUpdateTestLP(p3, 8.0, 6.0, 3.0);
+  EXPECT_TRUE(interface.UpdateModel(p3));
+  ASSERT_EQ(2u, be.objs_.size());
+  EXPECT_EQ("0: 2 terms, coef0=3", be.objs_.back());
+  EXPECT_EQ(2u, be.updates_.size());
+}
+
+TEST(ModelUpdateTest, NoUpdateForChangedStructure) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::FlatConverter, UpdatingBackend> >;
+  mp::Env env;
+  Interface interface(env);
+  interface.InitOptions();
+  BuildUpdateTestLP(interface.GetModel(), 10.0, 5.0, 1.0);
+  interface.ConvertModel();
+  mp::Problem p2;
+  BuildUpdateTestLP(p2, 10.0, 5.0, 1.0, 3.0);  // constraint matrix changed
+  EXPECT_FALSE(interface.UpdateModel(p2));
+  EXPECT_TRUE(interface.GetFlatCvt().GetModelAPI().updates_.empty());
+}
+
+TEST(ModelUpdateTest, NoUpdateWithoutModelAPISupport) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::FlatConverter, LinConBlockBackend> >;
+  mp::Env env;
+  Interface interface(env);
+  interface.InitOptions();
+  auto& p = interface.GetModel();
+  p.AddVars(2, 0.0, 10.0);
+  mp::Problem p2;
+  p2.AddVars(2, 0.0, 5.0);
+  interface.ConvertModel();
+  EXPECT_FALSE(interface.UpdateModel(p2));
+}
+
+
+/////////////////////////////// Solution check ////////////////////////////////
+TEST(SolutionCheckTest, ComputeActivitiesOnSeveralThreads) {
+  std::deque<mp::LinConRange> cons;
+  std::vector<const mp::LinConRange*> pcons;
+  const std::vector<double> x{1.0, 2.0, 3.0, 4.0, 5.0};
+  for (int i=0; i<50; ++i) {
+    mp::LinTerms lt;
+    for (int j=0; j<=i%5; ++j)
+      lt.add_term(i+j, j);
+    cons.emplace_back(std::move(lt), mp::AlgConRange{-INFINITY, 0.0});
+    pcons.push_back(&cons.back());
+  }
+  auto act1 = mp::ComputeActivities(pcons, x, 1);
+  auto act4 = mp::ComputeActivities(pcons, x, 4, 1);
+  ASSERT_EQ(pcons.size(), act1.size());
+  for (size_t i=0; i<pcons.size(); ++i) {
+    double s=0.0;
+    for (int j=0; j<=int(i)%5; ++j)
+      s += (i+j) * x[j];
+    EXPECT_EQ(s, act1[i]);
+    EXPECT_EQ(s, act4[i]);
+  }
+}
+
+TEST(SolutionCheckTest, ReportsViolatedLinearConstraints) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::FlatConverter, LinConBlockBackend> >;
+  mp::Env env;
+  Interface interface(env);
+  interface.InitOptions();
+  auto& p = interface.GetModel();
+  p.AddVars(2, 0.0, 10.0);
+  auto le = p.AddCon(-INFINITY, 5.0).set_linear_expr(2);
+  le.AddTerm(0, 1.0);
+  le.AddTerm(1, 2.0);
+  auto ge = p.AddCon(4.0, INFINITY).set_linear_expr(1);
+  ge.AddTerm(0, 1.0);
+  interface.ConvertModel();
+  const auto& fm = interface.GetFlatCvt().GetModel();
+  EXPECT_EQ(0, fm.CheckSolution(std::vector<double>{4.0, 0.5}, 1e-6, 1, env));
+  EXPECT_EQ(1, fm.CheckSolution(std::vector<double>{4.0, 1.0}, 1e-6, 1, env));
+  EXPECT_EQ(2, fm.CheckSolution(std::vector<double>{3.0, 2.0}, 1e-6, 1, env));
+  EXPECT_EQ(0, fm.CheckSolution(std::vector<double>{3.0, 2.0}, 2.0, 1, env));
+}
+
+
+/////////////////////////////// Solution pool postsolve ///////////////////////
+TEST(PostsolveSolutionsTest, ThreadsGiveSameSolutions) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::FlatConverter, LinConBlockBackend> >;
+  mp::Env env;
+  Interface interface(env);
+  interface.InitOptions();
+  auto& p = interface.GetModel();
+  p.AddVars(3, 0.0, 10.0);
+  auto le = p.AddCon(-INFINITY, 5.0).set_linear_expr(2);
+  le.AddTerm(0, 1.0);
+  le.AddTerm(1, 2.0);
+  auto ge = p.AddCon(1.0, INFINITY).set_linear_expr(2);
+  ge.AddTerm(1, 1.0);
+  ge.AddTerm(2, 1.0);
+  interface.ConvertModel();
+  auto& vp = interface.GetFlatCvt().GetValuePresolver();
+  std::vector<mp::pre::ModelValuesDbl> pool;
+  for (int k=0; k<20; ++k)
+    pool.push_back({ std::vector<double>{ k+0.5, k+1.5, k+2.5 },
+                     std::vector<double>{ -k*1.0, k*2.0 },
+                     std::vector<double>{ k*3.0 } });
+  std::vector<mp::pre::ModelValuesDbl> expected;
+  for (const auto& mv: pool)
+    expected.push_back(vp.PostsolveSolution(mv));
+  for (int nthreads: {1, 4}) {
+    vp.SetPostsolveThreads(nthreads);
+    auto result = vp.PostsolveSolutions(pool);
+    ASSERT_EQ(pool.size(), result.size());
+    for (size_t k=0; k<pool.size(); ++k) {
+      EXPECT_EQ(expected[k].GetVarValues()(), result[k].GetVarValues()());
+      EXPECT_EQ(expected[k].GetConValues()(), result[k].GetConValues()());
+      EXPECT_EQ(expected[k].GetObjValues()(), result[k].GetObjValues()());
+    }
+  }
+  // The default slot is still in use
+  auto mv = vp.PostsolveSolution(pool[7]);
+  EXPECT_EQ(expected[7].GetVarValues()(), mv.GetVarValues()());
+}
+
+
+/////////////////////////////// Model cache ///////////////////////////////////
+/// A backend recording the model serialized
+class CachingBackend : public mp::BasicFlatModelAPI {
+public:
+  CachingBackend(mp::Env& ) { }
+
+  static constexpr const char* GetTypeName() { return "Model cache tester"; }
+
+  void AddVariables(const mp::VarArrayDef& vad) {
+    for (int i=0; i<vad.size(); ++i)
+      vars_.push_back(fmt::format("[{}, {}] {}", vad.plb()[i], vad.pub()[i],
+                                  (int)vad.ptype()[i]));
+  }
+
+  void SetLinearObjective(int , const mp::LinearObjective& lo) {
+    mp::BinaryWriter wrt;
+    Serialize(wrt, lo.coefs());
+    Serialize(wrt, lo.vars());
+    items_.push_back(wrt.GetData());
+  }
+
+  using mp::BasicFlatModelAPI::AcceptanceLevel;
+  using mp::BasicFlatModelAPI::GroupNumber;
+  ACCEPT_CONSTRAINT(mp::LinConLE, mp::Recommended, mp::CG_Default)
+  ACCEPT_CONSTRAINT(mp::LinConEQ, mp::Recommended, mp::CG_Default)
+  ACCEPT_CONSTRAINT(mp::LinConGE, mp::Recommended, mp::CG_Default)
+  ACCEPT_CONSTRAINT(mp::MaxConstraint, mp::Recommended, mp::CG_Default)
+
+  template <class Constraint>
+  void AddConstraint(const Constraint& con) {
+    mp::BinaryWriter wrt;
+    Serialize(wrt, con);
+    items_.push_back(Constraint::GetTypeName() + wrt.GetData());
+  }
+
+  std::vector<std::string> vars_, items_;
+};
+
+using CachingInterface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+  mp::FlatCvtImpl<mp::FlatConverter, CachingBackend> >;
+
+/// Build and convert a model using the cache in the current directory,
+/// \a fClear: remove the cache file before.
+/// Postsolve a dummy solution.
+/// @return whether the model was read from the cache
+bool ConvertWithCache(CachingInterface& interface, mp::Env& env,
+                      bool fClear, mp::pre::ModelValuesDbl& sol) {
+  interface.InitOptions();
+  env.ParseOptionString("cvt:cache=.", 0);
+  auto& p = interface.GetModel();
+  p.AddVars(3, 0.0, 10.0);
+  p.AddVar(0.0, 5.0, mp::var::INTEGER);
+  auto obj = p.AddObj(mp::obj::MIN, 2);
+  obj.AddTerm(0, 1.0);
+  obj.AddTerm(1, 1.0);
+  auto rng = p.AddCon(1.0, 8.0).set_linear_expr(2);  // gets a slack
+  rng.AddTerm(0, 1.0);
+  rng.AddTerm(1, 2.0);
+  auto ge = p.AddCon(0.0, INFINITY).set_linear_expr(2);
+  ge.AddTerm(3, 1.0);
+  ge.AddTerm(2, -1.0);
+  p.AddCon(5.0, 5.0).set_nonlinear_expr(
+        MakeIterated(p, mp::expr::MAX, std::vector<int>{0, 1, 2}));
+  auto& cvt = interface.GetFlatCvt();
+  cvt.SetModelCacheKey(20230918);       // Would be the NL file hash
+  if (fClear)
+    std::remove(cvt.GetModelCacheFileName().c_str());
+  interface.ConvertModel();
+  auto& vp = cvt.GetValuePresolver();
+  std::vector<double> x(vp.GetTargetNodes().GetVarValues()().Size());
+  std::vector<double> y(vp.GetTargetNodes().GetConValues()().Size());
+  for (size_t i=0; i<x.size(); ++i)
+    x[i] = 0.5*i;
+  for (size_t i=0; i<y.size(); ++i)
+    y[i] = 1.0 + i;
+  sol = vp.PostsolveSolution({ x, y, std::vector<double>{ 3.0 } });
+  return cvt.IfModelCacheHit();
+}
+
+TEST(ModelCacheTest, CachedModelIsPassedToModelAPI) {
+  mp::Env env1;
+  CachingInterface interface1(env1);
+  mp::pre::ModelValuesDbl sol1;
+  EXPECT_FALSE(ConvertWithCache(interface1, env1, true, sol1));
+  mp::Env env2;
+  CachingInterface interface2(env2);
+  mp::pre::ModelValuesDbl sol2;
+  EXPECT_TRUE(ConvertWithCache(interface2, env2, false, sol2));
+  std::remove(interface2.GetFlatCvt().GetModelCacheFileName().c_str());
+  const auto& be1 = interface1.GetFlatCvt().GetModelAPI();
+  const auto& be2 = interface2.GetFlatCvt().GetModelAPI();
+  EXPECT_EQ(6u, be1.vars_.size());      // 4 + slack + max result
+  EXPECT_EQ(be1.vars_, be2.vars_);
+  EXPECT_EQ(be1.items_, be2.items_);
+  EXPECT_EQ(sol1.GetVarValues()(), sol2.GetVarValues()());
+  EXPECT_EQ(sol1.GetConValues()(), sol2.GetConValues()());
+  EXPECT_EQ(sol1.GetObjValues()(), sol2.GetObjValues()());
+}
+
+
+/////////////////////////////// Run statistics ////////////////////////////////
+/// Env with the standard options
+class RunStatsEnv : public mp::Env {
+public:
+  RunStatsEnv() : mp::Env("runstats", "runstats", 0, 0) { }
+};
+
+TEST(RunStatsTest, ConversionPhasesAndKeepersAreRecorded) {
+  RunStatsEnv env;
+  CachingInterface interface(env);
+  EXPECT_EQ(nullptr, env.GetRunStats());
+  env.ParseOptionString("tech:timing:json=runstats.json", 0);
+  ASSERT_NE(nullptr, env.GetRunStats());
+  mp::pre::ModelValuesDbl sol;
+  EXPECT_FALSE(ConvertWithCache(interface, env, true, sol));
+  std::remove(interface.GetFlatCvt().GetModelCacheFileName().c_str());
+  fmt::MemoryWriter wrt;
+  env.GetRunStats()->WriteJSON(wrt);
+  auto json = wrt.str();
+  for (const char* key: { "\"phases\"", "\"ConvertStandardItems\"",
+       "\"Convert2Cones\"", "\"ConvertAllConstraints\"",
+       "\"PushModelTo\"", "\"keepers\"", "\"links\"",
+       "\"postsolve\"", "\"Solution\"", "\"calls\": 1" })
+    EXPECT_NE(std::string::npos, json.find(key)) << key;
+  std::string max_stats = "\"MaxConstraint\": {";
+  auto pos = json.find(max_stats);
+  ASSERT_NE(std::string::npos, pos);
+  EXPECT_EQ(pos + max_stats.size(),
+            json.find(" \"added\": 1, \"calls\": ", pos));
+  env.WriteRunStats();
+  std::string json_file;
+  EXPECT_TRUE(mp::ReadFileToString("runstats.json", json_file));
+  EXPECT_EQ(json, json_file);
+  std::remove("runstats.json");
+}
+
+
+/////////////////////////////// Common expression inlining ///////////////////
+/// Convert a model with common expressions
+/// ce0 = x0+2*x1 (used once) and ce1 = x0-x1 (used twice)
+std::vector<std::string> ConvertCommonExprs(
+    const char* options, double& n_inlined, double& n_vars) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::FlatConverter, LinConBlockBackend> >;
+  RunStatsEnv env;
+  Interface interface(env);
+  interface.InitOptions();
+  env.ParseOptionString(options, 0);
+  auto& p = interface.GetModel();
+  p.AddVars(3, 0.0, 10.0);
+  auto x = [&p](int i) { return p.MakeVariable(i); };
+  p.AddCommonExpr(p.MakeBinary(mp::expr::ADD, x(0),
+      p.MakeBinary(mp::expr::MUL, p.MakeNumericConstant(2.0), x(1))));
+  p.AddCommonExpr(p.MakeBinary(mp::expr::SUB, x(0), x(1)));
+  p.AddCon(-INFINITY, 5.0).set_nonlinear_expr(
+        p.MakeBinary(mp::expr::ADD, p.MakeCommonExpr(0), x(2)));
+  p.AddCon(-INFINITY, 3.0).set_nonlinear_expr(
+        p.MakeBinary(mp::expr::ADD, p.MakeCommonExpr(1), x(0)));
+  p.AddCon(1.0, INFINITY).set_nonlinear_expr(
+        p.MakeBinary(mp::expr::SUB, p.MakeCommonExpr(1), x(2)));
+  interface.ConvertModel();
+  n_inlined = env.GetRunStats()->Get("model", "common_exprs", "inlined");
+  n_vars = env.GetRunStats()->Get("model", "common_exprs", "vars");
+  return interface.GetFlatCvt().GetModelAPI().blocks_;
+}
+
+TEST(CommonExprTest, ShortAffineOnceUsedIsInlined) {
+  double n_inlined=0.0, n_vars=0.0;
+  auto blocks = ConvertCommonExprs("tech:timing:json=runstats.json",
+                                   n_inlined, n_vars);
+  EXPECT_EQ(1.0, n_inlined);
+  EXPECT_EQ(1.0, n_vars);
+  EXPECT_NE(blocks.end(), std::find(blocks.begin(), blocks.end(),
+            "-inf <= 1*x0 2*x1 1*x2 <= 5; "
+            "-inf <= 1*x0 1*x3 <= 3; "
+            "1 <= -1*x2 1*x3 <= inf; "));
+  blocks = ConvertCommonExprs(
+        "tech:timing:json=runstats.json cvt:expr:inlineuses=2",
+        n_inlined, n_vars);
+  EXPECT_EQ(2.0, n_inlined);
+  EXPECT_EQ(0.0, n_vars);
+  blocks = ConvertCommonExprs(
+        "tech:timing:json=runstats.json cvt:expr:inlineuses=0",
+        n_inlined, n_vars);
+  EXPECT_EQ(0.0, n_inlined);
+  EXPECT_EQ(2.0, n_vars);
+}
+
+
+/////////////////////////////// Bound propagation ///////////////////////////
+/// x0 + x1 <= 4, x0 >= 3, 2*x2 - x1 <= 4 with integer x2:
+/// ub(x1) = 1, ub(x2) = 2, unless switched off
+TEST(BoundPropagationTest, LinearRowsTightenVariableBounds) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::FlatConverter, LinConBlockBackend> >;
+  for (int fbbt: {0, 1}) {
+    RunStatsEnv env;
+    Interface interface(env);
+    interface.InitOptions();
+    env.ParseOptionString(fbbt ?
+                            "tech:timing:json=runstats.json" :
+                            "tech:timing:json=runstats.json cvt:pre:fbbt=0",
+                          0);
+    auto& p = interface.GetModel();
+    p.AddVars(2, 0.0, 10.0);
+    p.AddVar(0.0, 10.0, mp::var::INTEGER);
+    auto le = p.AddCon(-INFINITY, 4.0).set_linear_expr(2);
+    le.AddTerm(0, 1.0);
+    le.AddTerm(1, 1.0);
+    p.AddCon(3.0, INFINITY).set_linear_expr(1).AddTerm(0, 1.0);
+    auto le2 = p.AddCon(-INFINITY, 4.0).set_linear_expr(2);
+    le2.AddTerm(2, 2.0);
+    le2.AddTerm(1, -1.0);
+    interface.ConvertModel();
+    const auto& cvt = interface.GetFlatCvt();
+    EXPECT_EQ(fbbt ? 3.0 : 0.0, cvt.lb(0));
+    EXPECT_EQ(fbbt ? 4.0 : 10.0, cvt.ub(0));
+    EXPECT_EQ(fbbt ? 1.0 : 10.0, cvt.ub(1));
+    EXPECT_EQ(fbbt ? 2.0 : 10.0, cvt.ub(2));
+    EXPECT_EQ(0 != fbbt,
+              0.0 < env.GetRunStats()->Get("presolve", "fbbt", "tightened"));
+  }
+}
+
+/// Infeasibility stops the propagation, the model is passed on
+TEST(BoundPropagationTest, InfeasibilityIsLeftToTheSolver) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::FlatConverter, LinConBlockBackend> >;
+  RunStatsEnv env;
+  Interface interface(env);
+  interface.InitOptions();
+  env.ParseOptionString("tech:timing:json=runstats.json", 0);
+  auto& p = interface.GetModel();
+  p.AddVars(2, 0.0, 10.0);
+  auto le = p.AddCon(-INFINITY, 4.0).set_linear_expr(2);
+  le.AddTerm(0, 1.0);
+  le.AddTerm(1, 1.0);
+  p.AddCon(5.0, INFINITY).set_linear_expr(1).AddTerm(0, 1.0);
+  interface.ConvertModel();
+  EXPECT_EQ(1.0, env.GetRunStats()->Get("presolve", "fbbt", "infeasible"));
+  const auto& cvt = interface.GetFlatCvt();
+  EXPECT_LE(cvt.lb(0), cvt.ub(0));
+  EXPECT_LE(cvt.lb(1), cvt.ub(1));
+  EXPECT_EQ(1u, cvt.GetModelAPI().blocks_.size());
+}
+
+
+/////////////////////////////// Link compression //////////////////////////////
+TEST(One2ManyLinkTest, MergesEquallyWideConsecutiveEntries) {
+  mp::Env env;
+  mp::pre::ValuePresolver vp(env);
+  mp::pre::One2ManyLink link(vp);
+  auto& src = vp.GetSourceNodes().GetVarValues()();
+  auto& dest = vp.GetTargetNodes().GetVarValues()();
+  for (int i=0; i<4; ++i)              // x_i -> y_2i, y_2i+1
+    link.AddEntry({src.Add(), dest.Add(2)});
+  EXPECT_EQ(1, link.GetNumberOfEntries());
+  auto s4 = src.Add();                 // width 3: new entry
+  link.AddEntry({s4, dest.Add()});
+  link.AddEntry({s4, dest.Add()});
+  link.AddEntry({s4, dest.Add()});
+  EXPECT_EQ(2, link.GetNumberOfEntries());
+  auto mv = vp.PostsolveSolution(
+        { std::vector<double>{ 1, 2, 3, 4, 5, 6, 7, 8, 0, 9, 0 } });
+  EXPECT_EQ(std::vector<double>({ 2, 4, 6, 8, 9 }),
+            mv.GetVarValues()());
+  auto mvp = vp.PresolveSolution(
+        { std::vector<double>{ 1, 2, 3, 4, 5 } });
+  EXPECT_EQ(std::vector<double>({ 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 5 }),
+            mvp.GetVarValues()());
+}
+
 } // namespace
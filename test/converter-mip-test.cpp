@@ -20,6 +20,10 @@
  Author: Gleb Belov <Gleb.Belov@monash.edu>
  */
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "converter-mip-test.h"
@@ -53,4 +57,163 @@ TEST(RedefsMIPTest, PureMILP__01__seemsPassedToBackendCorrectly) {
   ASSERT_TRUE(tester.NConstrEqual(milp));
 }
 
+/// Piecewise-linear constraints received by a backend
+struct PLRecord {
+  /// Variables (arguments, result), breakpoints
+  std::vector< std::vector<int> > vars_;
+  std::vector< std::vector<double> > x_, y_;
+};
+
+/// A backend recording piecewise-linear constraints
+class PLRecordingBackend :
+    public mp::BasicFlatModelAPI,
+    public mp::EnvKeeper
+{
+public:
+  PLRecordingBackend(mp::Env& e) : mp::EnvKeeper(e) { }
+
+  static constexpr const char* GetTypeName() { return "PL recorder"; }
+
+  void AddVariables(const mp::VarArrayDef& ) { }
+  void SetLinearObjective(int , const mp::LinearObjective& ) { }
+
+  USE_BASE_CONSTRAINT_HANDLERS(mp::BasicFlatModelAPI)
+
+  ACCEPT_CONSTRAINT(mp::LinConRange, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConLE, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConEQ, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConGE, mp::Recommended, mp::CG_Linear)
+  void AddConstraint(const mp::LinConRange& ) { }
+  void AddConstraint(const mp::LinConLE& ) { }
+  void AddConstraint(const mp::LinConEQ& ) { }
+  void AddConstraint(const mp::LinConGE& ) { }
+
+  ACCEPT_CONSTRAINT(mp::PLConstraint, mp::Recommended,
+                    mp::CG_Piecewiselinear)
+  void AddConstraint(const mp::PLConstraint& plc) {
+    mp::PLPoints plp = plc.GetParameters();
+    const auto& args = plc.GetArguments();
+    rec_.vars_.push_back({ args.begin(), args.end() });
+    rec_.vars_.back().push_back(plc.GetResultVar());
+    rec_.x_.push_back(plp.x_);
+    rec_.y_.push_back(plp.y_);
+  }
+
+  PLRecord rec_;
+};
+
+/// Convert exp(x_i) <= 20, sin(x_i) >= -0.5 with \a nthreads
+PLRecord ConvertSmoothFunctions(int nthreads) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::MIPFlatConverter, PLRecordingBackend> >;
+  mp::Env e;
+  Interface interface(e);
+  interface.InitOptions();
+  e.ParseOptionString(
+        fmt::format("cvt:plapprox:threads={}", nthreads).c_str(), 0);
+  auto& p = interface.GetModel();
+  const int n = 500;
+  for (int i=0; i<n; ++i)
+    p.AddVar(-1.0 - 0.01*i, 2.0 + 0.1*i);
+  for (int i=0; i<n; ++i) {
+    p.AddCon(-INFINITY, 20.0).set_nonlinear_expr(
+          p.MakeUnary(mp::expr::EXP, p.MakeVariable(i)));
+    p.AddCon(-0.5, INFINITY).set_nonlinear_expr(
+          p.MakeUnary(mp::expr::SIN, p.MakeVariable(i)));
+  }
+  interface.ConvertModel();
+  return interface.GetFlatCvt().GetModelAPI().rec_;
+}
+
+TEST(RedefsMIPTest, PLApproxThreadsGiveSameModel) {
+  auto serial = ConvertSmoothFunctions(1);
+  auto parallel = ConvertSmoothFunctions(4);
+  EXPECT_EQ(1000u, serial.vars_.size());
+  EXPECT_EQ(serial.vars_, parallel.vars_);
+  EXPECT_EQ(serial.x_, parallel.x_);
+  EXPECT_EQ(serial.y_, parallel.y_);
+}
+
+/// Env with the standard options
+class RunStatsEnv : public mp::Env {
+public:
+  RunStatsEnv() : mp::Env("runstats", "runstats", 0, 0) { }
+};
+
+/// A backend recording the right-hand sides
+/// of linear <= constraints
+class LinLERecordingBackend :
+    public mp::BasicFlatModelAPI,
+    public mp::EnvKeeper
+{
+public:
+  LinLERecordingBackend(mp::Env& e) : mp::EnvKeeper(e) { }
+
+  static constexpr const char* GetTypeName() { return "LinLE recorder"; }
+
+  void AddVariables(const mp::VarArrayDef& ) { }
+  void SetLinearObjective(int , const mp::LinearObjective& ) { }
+
+  USE_BASE_CONSTRAINT_HANDLERS(mp::BasicFlatModelAPI)
+
+  ACCEPT_CONSTRAINT(mp::LinConRange, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConLE, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConEQ, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConGE, mp::Recommended, mp::CG_Linear)
+  void AddConstraint(const mp::LinConRange& ) { }
+  void AddConstraint(const mp::LinConLE& le) { rhs_.push_back(le.rhs()); }
+  void AddConstraint(const mp::LinConEQ& ) { }
+  void AddConstraint(const mp::LinConGE& ) { }
+
+  std::vector<double> rhs_;
+};
+
+/// Convert x0 - 97*b <= 3, x1 - 98*b <= 2, b==1 ==> x0+x1 <= 4,
+/// x0, x1 in [0, 100].
+/// The big-M constraint is x0+x1 + (U-4)*r <= U,
+/// where U bounds x0+x1 when the indicator r is 0
+std::vector<double> ConvertIndicatorModel(const char* options,
+                                          double& n_narrowed) {
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+    mp::FlatCvtImpl<mp::MIPFlatConverter, LinLERecordingBackend> >;
+  RunStatsEnv e;
+  Interface interface(e);
+  interface.InitOptions();
+  e.ParseOptionString(options, 0);
+  auto& p = interface.GetModel();
+  p.AddVars(2, 0.0, 100.0);
+  p.AddVar(0.0, 1.0, mp::var::INTEGER);
+  auto le0 = p.AddCon(-INFINITY, 3.0).set_linear_expr(2);
+  le0.AddTerm(0, 1.0);
+  le0.AddTerm(2, -97.0);
+  auto le1 = p.AddCon(-INFINITY, 2.0).set_linear_expr(2);
+  le1.AddTerm(1, 1.0);
+  le1.AddTerm(2, -98.0);
+  p.AddCon(p.MakeImplication(
+             p.MakeRelational(mp::expr::EQ, p.MakeVariable(2),
+                              p.MakeNumericConstant(1.0)),
+             p.MakeRelational(mp::expr::LE,
+                              p.MakeBinary(mp::expr::ADD,
+                                           p.MakeVariable(0),
+                                           p.MakeVariable(1)),
+                              p.MakeNumericConstant(4.0)),
+             p.MakeLogicalConstant(true)));
+  interface.ConvertModel();
+  n_narrowed = e.GetRunStats()->Get("presolve", "bigM_probe", "narrowed");
+  return interface.GetFlatCvt().GetModelAPI().rhs_;
+}
+
+TEST(RedefsMIPTest, BigMIsTightenedByProbing) {
+  double n_narrowed = 0.0;
+  auto rhs = ConvertIndicatorModel("tech:timing:json=runstats.json",
+                                   n_narrowed);
+  EXPECT_EQ(1.0, n_narrowed);
+  EXPECT_NE(rhs.end(), std::find(rhs.begin(), rhs.end(), 5.0));
+  rhs = ConvertIndicatorModel(
+        "tech:timing:json=runstats.json cvt:mip:probe=0", n_narrowed);
+  EXPECT_EQ(0.0, n_narrowed);
+  EXPECT_EQ(rhs.end(), std::find(rhs.begin(), rhs.end(), 5.0));
+  EXPECT_NE(rhs.end(), std::find(rhs.begin(), rhs.end(), 200.0));
+}
+
 }
@@ -0,0 +1,17 @@
+x-VISITOR 0.0.0: not solved
+0 simplex iterations
+
+
+Options
+3
+2
+1
+0
+1
+1
+2
+2
+0
+0
+0
+objno 0 -1
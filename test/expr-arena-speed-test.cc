@@ -0,0 +1,124 @@
+/*
+ Expression construction and flattening with the default expression
+ allocator vs ArenaAllocator.
+
+ Copyright (C) 2023 AMPL Optimization Inc
+
+ Permission to use, copy, modify, and distribute this software and its
+ documentation for any purpose and without fee is hereby granted,
+ provided that the above copyright notice appear in all copies and that
+ both that the copyright notice and this permission notice and warranty
+ disclaimer appear in supporting documentation.
+
+ The author and AMPL Optimization Inc disclaim all warranties with
+ regard to this software, including all implied warranties of
+ merchantability and fitness.  In no event shall the author be liable
+ for any special, indirect or consequential damages or any damages
+ whatsoever resulting from loss of use, data or profits, whether in an
+ action of contract, negligence or other tortious action, arising out
+ of or in connection with the use or performance of this software.
+
+ Usage: expr-arena-speed-test [num_cons [terms_per_con]]
+ */
+
+#include <cstdlib>
+#include <vector>
+
+#include "mp/clock.h"
+#include "mp/flat/model_api_base.h"
+#include "mp/flat/problem_flattener.h"
+#include "mp/flat/converter.h"
+
+namespace {
+
+// A backend that accepts linear and quadratic constraints.
+class QuadBackend : public mp::BasicFlatModelAPI {
+  using Base = mp::BasicFlatModelAPI;
+  int num_vars_ = 0;
+  int num_cons_ = 0;
+
+ public:
+  QuadBackend() { }
+  QuadBackend(mp::Env &) { }
+
+  static constexpr const char *GetTypeName() { return "speed-test"; }
+
+  void AddVariables(const mp::VarArrayDef &v) { num_vars_ = (int)v.size(); }
+  int NumVars() const { return num_vars_; }
+  int NumCons() const { return num_cons_; }
+
+  USE_BASE_CONSTRAINT_HANDLERS(Base)
+  ACCEPT_CONSTRAINT(mp::LinConRange, mp::Recommended, mp::CG_Default)
+  ACCEPT_CONSTRAINT(mp::LinConLE, mp::Recommended, mp::CG_Default)
+  ACCEPT_CONSTRAINT(mp::LinConEQ, mp::Recommended, mp::CG_Default)
+  ACCEPT_CONSTRAINT(mp::LinConGE, mp::Recommended, mp::CG_Default)
+  ACCEPT_CONSTRAINT(mp::QuadConRange, mp::Recommended, mp::CG_Default)
+  ACCEPT_CONSTRAINT(mp::QuadConLE, mp::Recommended, mp::CG_Default)
+  ACCEPT_CONSTRAINT(mp::QuadConEQ, mp::Recommended, mp::CG_Default)
+  ACCEPT_CONSTRAINT(mp::QuadConGE, mp::Recommended, mp::CG_Default)
+  void AddConstraint(const mp::LinConRange &) { ++num_cons_; }
+  void AddConstraint(const mp::LinConLE &) { ++num_cons_; }
+  void AddConstraint(const mp::LinConEQ &) { ++num_cons_; }
+  void AddConstraint(const mp::LinConGE &) { ++num_cons_; }
+  void AddConstraint(const mp::QuadConRange &) { ++num_cons_; }
+  void AddConstraint(const mp::QuadConLE &) { ++num_cons_; }
+  void AddConstraint(const mp::QuadConEQ &) { ++num_cons_; }
+  void AddConstraint(const mp::QuadConGE &) { ++num_cons_; }
+};
+
+template <typename Alloc>
+struct Timing {
+  double build_time;
+  double flatten_time;
+  int num_cons;
+};
+
+// Builds constraints sum_k (x[i+k] * x[i+k+1] + 2 * x[i+k+1]) >= -1
+// and flattens them.
+template <typename Alloc>
+Timing<Alloc> Run(int num_cons, int terms_per_con) {
+  using Problem = mp::BasicProblem< mp::BasicProblemParams<Alloc> >;
+  using Interface = mp::ProblemFltImpl<mp::ProblemFlattener, Problem,
+      mp::FlatCvtImpl<mp::FlatConverter, QuadBackend> >;
+  mp::Env env;
+  Interface interface(env);
+  interface.InitOptions();
+  Problem &p = interface.GetModel();
+  Timing<Alloc> t;
+  mp::steady_clock::time_point start = mp::steady_clock::now();
+  int num_vars = num_cons + terms_per_con + 1;
+  p.AddVars(num_vars, -10, 10);
+  for (int i = 0; i < num_cons; ++i) {
+    auto sum = p.BeginIterated(mp::expr::SUM, terms_per_con);
+    for (int k = 0; k < terms_per_con; ++k) {
+      auto lin = p.MakeBinary(mp::expr::MUL, p.MakeNumericConstant(2),
+                              p.MakeVariable(i + k + 1));
+      auto quad = p.MakeBinary(mp::expr::MUL, p.MakeVariable(i + k),
+                               p.MakeVariable(i + k + 1));
+      sum.AddArg(p.MakeBinary(mp::expr::ADD, quad, lin));
+    }
+    p.AddCon(-1, INFINITY).set_nonlinear_expr(p.EndIterated(sum));
+  }
+  t.build_time = mp::GetTimeAndReset(start);
+  interface.ConvertModel();
+  t.flatten_time = mp::GetTimeAndReset(start);
+  t.num_cons = interface.GetFlatCvt().GetModelAPI().NumCons();
+  return t;
+}
+
+template <typename Alloc>
+void Report(const char *name, int num_cons, int terms_per_con) {
+  Timing<Alloc> t = Run<Alloc>(num_cons, terms_per_con);
+  fmt::print("{:<16} build {:.3f} s, flatten {:.3f} s ({} constraints)\n",
+             name, t.build_time, t.flatten_time, t.num_cons);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int num_cons = argc > 1 ? std::atoi(argv[1]) : 100000;
+  int terms_per_con = argc > 2 ? std::atoi(argv[2]) : 20;
+  fmt::print("{} constraints with {} quadratic terms ({} nodes).\n",
+             num_cons, terms_per_con, num_cons * (terms_per_con * 7 + 1));
+  Report< std::allocator<char> >("std::allocator", num_cons, terms_per_con);
+  Report<mp::ArenaAllocator>("ArenaAllocator", num_cons, terms_per_con);
+}
@@ -931,6 +931,47 @@ TEST(ExprFactoryTest, FuncMemoryAllocation) {
   EXPECT_CALL(alloc, deallocate(buffer, _));
 }
 
+TEST(ArenaAllocatorTest, Allocate) {
+  mp::ArenaAllocator arena;
+  EXPECT_EQ(0u, arena.allocated());
+  char *prev = 0;
+  for (std::size_t size = 1; size < 100; ++size) {
+    char *p = arena.allocate(size);
+    EXPECT_EQ(0u, reinterpret_cast<std::size_t>(p) % sizeof(double));
+    EXPECT_EQ(0u, reinterpret_cast<std::size_t>(p) % sizeof(void*));
+    if (prev)
+      EXPECT_GE(p - prev, static_cast<std::ptrdiff_t>(size - 1));
+    std::fill(p, p + size, 'x');
+    prev = p;
+  }
+  std::size_t allocated = arena.allocated();
+  EXPECT_GT(allocated, 0u);
+  // A large object gets a block of its own.
+  char *large = arena.allocate(1 << 20);
+  large[(1 << 20) - 1] = 'x';
+  EXPECT_GE(arena.allocated(), allocated + (1 << 20));
+  EXPECT_EQ(prev + 104, arena.allocate(1));
+  EXPECT_EQ(0u, mp::ArenaAllocator(arena).allocated());
+}
+
+TEST(ExprFactoryTest, ArenaAllocator) {
+  mp::BasicExprFactory<mp::ArenaAllocator> f;
+  auto x = f.MakeVariable(0);
+  auto builder = f.BeginIterated(expr::SUM, 3);
+  builder.AddArg(f.MakeNumericConstant(42));
+  builder.AddArg(f.MakeBinary(expr::MUL, x, f.MakeVariable(1)));
+  builder.AddArg(f.MakeUnary(expr::EXP, x));
+  auto sum = f.EndIterated(builder);
+  auto func = f.AddFunction("foo", 1);
+  auto str = f.MakeStringLiteral("abc");
+  EXPECT_EQ("/* sum */ (42 + x1 * x2 + exp(x1))",
+            fmt::format("{}", NumericExpr(sum)));
+  EXPECT_EQ(3, sum.num_args());
+  EXPECT_STREQ("foo", func.name());
+  EXPECT_EQ(func, f.function(0));
+  EXPECT_STREQ("abc", str.value());
+}
+
 TEST(ExprFactoryTest, IntOverflow) {
   ExprFactory f;
   int int_max = std::numeric_limits<int>::max();
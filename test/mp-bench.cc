@@ -0,0 +1,628 @@
+/*
+ Benchmarks of the NL reader, the flattener, MIP redefinitions,
+ passing the flat model to a ModelAPI, and postsolve,
+ on parametric synthetic models written as text and binary NL.
+
+ Copyright (C) 2023 AMPL Optimization Inc
+
+ Permission to use, copy, modify, and distribute this software and its
+ documentation for any purpose and without fee is hereby granted,
+ provided that the above copyright notice appear in all copies and that
+ both that the copyright notice and this permission notice and warranty
+ disclaimer appear in supporting documentation.
+
+ The author and AMPL Optimization Inc disclaim all warranties with
+ regard to this software, including all implied warranties of
+ merchantability and fitness.  In no event shall the author be liable
+ for any special, indirect or consequential damages or any damages
+ whatsoever resulting from loss of use, data or profits, whether in an
+ action of contract, negligence or other tortious action, arising out
+ of or in connection with the use or performance of this software.
+
+ Usage: mp-bench [-s scale] [-r repetitions] [-m model[,model...]]
+                 [-d nl_dir] [-o results.json]
+
+ Models: lp (sparse LP with some integer variables),
+         qp (dense quadratic objective),
+         ite (deep if-then-else and logical trees),
+         pl (many piecewise-linear terms),
+         cexpr (many common expressions).
+ Each model is written as text and binary NL into nl_dir (default: .)
+ and processed by the standard model manager with the MIP converter
+ and a silent ModelAPI accepting the constraints of the visitor driver.
+ Phase times are taken from the run statistics (tech:timing:json).
+ The generator is seeded, so the models are reproducible.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mp/nl-reader.h"
+#include "mp/utils-file.h"
+#include "mp/model-mgr-with-std-pb.hpp"
+#include "mp/flat/problem_flattener.h"
+#include "mp/flat/redef/MIP/converter_mip.h"
+
+namespace {
+
+/// Writes NL tokens as text or binary.
+/// In text, each marker ('C', 'o', 'n', ...) starts a token group
+/// and numbers after it are separated by spaces;
+/// EndLine() is ignored in binary.
+class NLTokenWriter {
+ public:
+  explicit NLTokenWriter(bool binary) : binary_(binary) {}
+
+  void Header(mp::NLHeader h) {
+    h.format = binary_ ? mp::NLHeader::BINARY : mp::NLHeader::TEXT;
+    if (binary_)
+      h.arith_kind = mp::arith::GetKind();
+    w_ << h;
+  }
+
+  NLTokenWriter &Mark(char c) {
+    w_ << c;
+    sep_ = false;
+    return *this;
+  }
+
+  NLTokenWriter &Int(int i) {
+    if (binary_)
+      Raw(i);
+    else
+      w_ << (sep_ ? " " : "") << i;
+    sep_ = true;
+    return *this;
+  }
+
+  NLTokenWriter &Dbl(double d) {
+    if (binary_)
+      Raw(d);
+    else
+      w_.write(sep_ ? " {:.17}" : "{:.17}", d);
+    sep_ = true;
+    return *this;
+  }
+
+  NLTokenWriter &EndLine() {
+    if (!binary_)
+      w_ << '\n';
+    sep_ = false;
+    return *this;
+  }
+
+  std::string str() const { return w_.str(); }
+
+ private:
+  template <typename T>
+  void Raw(T v) {
+    const char *p = reinterpret_cast<const char*>(&v);
+    w_.buffer().append(p, p + sizeof(v));
+  }
+
+  bool binary_;
+  bool sep_ = false;
+  fmt::MemoryWriter w_;
+};
+
+/// An expression in NL prefix notation
+class NLExpr {
+ public:
+  NLExpr &Num(double d) { toks_.push_back({'n', 0, d}); return *this; }
+  NLExpr &Var(int v) { toks_.push_back({'v', v, 0.0}); return *this; }
+  NLExpr &Op(mp::expr::Kind k) {
+    toks_.push_back({'o', mp::expr::nl_opcode(k), 0.0});
+    return *this;
+  }
+  /// Number of arguments or slopes
+  NLExpr &Count(int n) { toks_.push_back({'\0', n, 0.0}); return *this; }
+
+  bool empty() const { return toks_.empty(); }
+
+  void WriteTo(NLTokenWriter &w) const {
+    if (toks_.empty())
+      w.Mark('n').Dbl(0.0).EndLine();
+    for (const auto &t: toks_) {
+      if ('n' == t.mark)
+        w.Mark('n').Dbl(t.d);
+      else if (t.mark)
+        w.Mark(t.mark).Int(t.i);
+      else
+        w.Int(t.i);
+      w.EndLine();
+    }
+  }
+
+ private:
+  struct Token {
+    char mark;
+    int i;
+    double d;
+  };
+  std::vector<Token> toks_;
+};
+
+typedef std::vector<std::pair<int, double> > LinTerms;
+
+/// A synthetic model
+struct SyntheticModel {
+  std::string name;
+  std::vector<double> var_lb, var_ub;
+  /// The last num_int_vars variables are integer
+  int num_int_vars = 0;
+  /// Variables 0..num_nl_vars-1 can appear in nonlinear expressions
+  int num_nl_vars = 0;
+
+  struct CommonExpr {
+    LinTerms lin;
+    NLExpr nl;
+  };
+  std::vector<CommonExpr> cexprs;
+
+  struct AlgCon {
+    double lb, ub;
+    LinTerms lin;
+    NLExpr nl;
+  };
+  /// Nonlinear constraints should come first
+  std::vector<AlgCon> cons;
+  std::vector<NLExpr> logical_cons;
+
+  LinTerms obj_lin;
+  NLExpr obj_nl;
+
+  int num_vars() const { return static_cast<int>(var_lb.size()); }
+
+  /// Write as text or binary NL
+  std::string WriteNL(bool binary) const;
+};
+
+/// Writes r segment or b segment bounds
+void WriteBound(NLTokenWriter &w, double lb, double ub) {
+  if (lb == ub)
+    w.Mark('4').Dbl(lb);
+  else if (lb == -INFINITY && ub == INFINITY)
+    w.Mark('3');
+  else if (lb == -INFINITY)
+    w.Mark('1').Dbl(ub);
+  else if (ub == INFINITY)
+    w.Mark('2').Dbl(lb);
+  else
+    w.Mark('0').Dbl(lb).Dbl(ub);
+  w.EndLine();
+}
+
+std::string SyntheticModel::WriteNL(bool binary) const {
+  mp::NLHeader h = mp::NLHeader();
+  h.num_vars = num_vars();
+  h.num_algebraic_cons = static_cast<int>(cons.size());
+  h.num_logical_cons = static_cast<int>(logical_cons.size());
+  h.num_objs = 1;
+  h.num_linear_integer_vars = num_int_vars;
+  h.num_common_exprs_in_cons = static_cast<int>(cexprs.size());
+  std::vector<int> col_sizes(num_vars());
+  for (const auto &c: cons) {
+    if (c.lb == c.ub)
+      ++h.num_eqns;
+    else if (c.lb != -INFINITY && c.ub != INFINITY)
+      ++h.num_ranges;
+    if (!c.nl.empty())
+      ++h.num_nl_cons;
+    h.num_con_nonzeros += static_cast<int>(c.lin.size());
+    for (const auto &t: c.lin)
+      ++col_sizes[t.first];
+  }
+  if (h.num_nl_cons || h.num_logical_cons)
+    h.num_nl_vars_in_cons = num_nl_vars;
+  if (!obj_nl.empty()) {
+    h.num_nl_objs = 1;
+    h.num_nl_vars_in_objs = num_nl_vars;
+  }
+  h.num_obj_nonzeros = static_cast<int>(obj_lin.size());
+
+  NLTokenWriter w(binary);
+  w.Header(h);
+  for (std::size_t i = 0; i < cexprs.size(); ++i) {
+    const auto &ce = cexprs[i];
+    w.Mark('V').Int(num_vars() + static_cast<int>(i))
+        .Int(static_cast<int>(ce.lin.size())).Int(0).EndLine();
+    for (const auto &t: ce.lin)
+      w.Int(t.first).Dbl(t.second).EndLine();
+    ce.nl.WriteTo(w);
+  }
+  for (std::size_t i = 0; i < cons.size(); ++i) {
+    w.Mark('C').Int(static_cast<int>(i)).EndLine();
+    cons[i].nl.WriteTo(w);
+  }
+  for (std::size_t i = 0; i < logical_cons.size(); ++i) {
+    w.Mark('L').Int(static_cast<int>(i)).EndLine();
+    logical_cons[i].WriteTo(w);
+  }
+  w.Mark('O').Int(0).Int(0).EndLine();
+  obj_nl.WriteTo(w);
+  if (cons.size()) {
+    w.Mark('r').EndLine();
+    for (const auto &c: cons)
+      WriteBound(w, c.lb, c.ub);
+  }
+  w.Mark('b').EndLine();
+  for (int j = 0; j < num_vars(); ++j)
+    WriteBound(w, var_lb[j], var_ub[j]);
+  if (num_vars() > 1) {
+    w.Mark('k').Int(num_vars() - 1).EndLine();
+    int col_start = 0;
+    for (int j = 0; j + 1 < num_vars(); ++j)
+      w.Int(col_start += col_sizes[j]).EndLine();
+  }
+  for (std::size_t i = 0; i < cons.size(); ++i) {
+    const auto &lin = cons[i].lin;
+    if (lin.empty())
+      continue;
+    w.Mark('J').Int(static_cast<int>(i))
+        .Int(static_cast<int>(lin.size())).EndLine();
+    for (const auto &t: lin)
+      w.Int(t.first).Dbl(t.second).EndLine();
+  }
+  if (obj_lin.size()) {
+    w.Mark('G').Int(0).Int(static_cast<int>(obj_lin.size())).EndLine();
+    for (const auto &t: obj_lin)
+      w.Int(t.first).Dbl(t.second).EndLine();
+  }
+  return w.str();
+}
+
+/// Seeded random numbers, so that the models are reproducible
+class Random {
+ public:
+  explicit Random(unsigned seed) : gen_(seed) {}
+
+  int Index(int n) {
+    return std::uniform_int_distribution<int>(0, n - 1)(gen_);
+  }
+
+  double Value(double lb, double ub) {
+    return std::uniform_real_distribution<double>(lb, ub)(gen_);
+  }
+
+  /// Linear terms with distinct variables from [0, n)
+  LinTerms Terms(int n, int nnz) {
+    LinTerms lt;
+    int stride = n / nnz;
+    int v = Index(n);
+    for (int k = 0; k < nnz; ++k)
+      lt.push_back({(v + k * stride) % n, Value(-10.0, 10.0)});
+    std::sort(lt.begin(), lt.end());
+    return lt;
+  }
+
+ private:
+  std::mt19937 gen_;
+};
+
+void AddVars(SyntheticModel &m, int n, double lb, double ub) {
+  m.var_lb.assign(n, lb);
+  m.var_ub.assign(n, ub);
+}
+
+/// Sparse LP: scale rows, 10 nonzeros per row, 10% integer variables
+SyntheticModel GenerateLP(int scale) {
+  SyntheticModel m;
+  m.name = "lp";
+  Random rnd(1);
+  int n = scale;
+  AddVars(m, n, 0.0, 100.0);
+  m.num_int_vars = n / 10;
+  for (int i = 0; i < n; ++i) {
+    double rhs = rnd.Value(10.0, 1000.0);
+    m.cons.push_back({i % 2 ? -INFINITY : -rhs, rhs,
+                      rnd.Terms(n, std::min(n, 10)), NLExpr()});
+  }
+  m.obj_lin = rnd.Terms(n, n);
+  return m;
+}
+
+/// Dense QP: d(d+1)/2 products in the objective, d = 2*sqrt(scale)
+SyntheticModel GenerateQP(int scale) {
+  SyntheticModel m;
+  m.name = "qp";
+  Random rnd(2);
+  int d = std::max(10, static_cast<int>(2 * std::sqrt(scale)));
+  AddVars(m, d, -10.0, 10.0);
+  m.num_nl_vars = d;
+  for (int i = 0; i < d; ++i)
+    m.cons.push_back({-INFINITY, rnd.Value(1.0, 10.0),
+                      rnd.Terms(d, 5), NLExpr()});
+  m.obj_nl.Op(mp::expr::SUM).Count(d * (d + 1) / 2);
+  for (int i = 0; i < d; ++i) {
+    for (int j = i; j < d; ++j) {
+      m.obj_nl.Op(mp::expr::MUL).Op(mp::expr::MUL)
+          .Num(i == j ? d : rnd.Value(-1.0, 1.0)).Var(i).Var(j);
+    }
+  }
+  m.obj_lin = rnd.Terms(d, d);
+  return m;
+}
+
+/// Deep trees: scale/50 constraints with if-then-else chains
+/// and as many logical constraints with and/or chains, depth 10
+SyntheticModel GenerateITE(int scale) {
+  SyntheticModel m;
+  m.name = "ite";
+  Random rnd(3);
+  const int depth = 10;
+  int n = std::max(10, scale / 10);
+  AddVars(m, n, 0.0, 10.0);
+  m.num_nl_vars = n;
+  int num_cons = std::max(1, scale / 50);
+  for (int i = 0; i < num_cons; ++i) {
+    NLExpr e;
+    for (int k = 0; k < depth; ++k) {
+      e.Op(mp::expr::IF).Op(mp::expr::GE)
+          .Var(rnd.Index(n)).Num(rnd.Value(0.0, 10.0)).Var(rnd.Index(n));
+    }
+    e.Var(rnd.Index(n));
+    m.cons.push_back({-INFINITY, 8.0, rnd.Terms(n, 2), e});
+  }
+  for (int i = 0; i < num_cons; ++i) {
+    NLExpr e;
+    for (int k = 0; k < depth; ++k) {
+      e.Op(k % 2 ? mp::expr::AND : mp::expr::OR).Op(mp::expr::LE)
+          .Var(rnd.Index(n)).Num(rnd.Value(0.0, 10.0));
+    }
+    e.Op(mp::expr::LE).Var(rnd.Index(n)).Num(rnd.Value(0.0, 10.0));
+    m.logical_cons.push_back(e);
+  }
+  m.obj_lin = rnd.Terms(n, std::min(n, 20));
+  return m;
+}
+
+/// Piecewise-linear: scale/20 constraints, each a sum of 4 PL terms
+/// with 5 slopes
+SyntheticModel GeneratePL(int scale) {
+  SyntheticModel m;
+  m.name = "pl";
+  Random rnd(4);
+  int n = std::max(10, scale / 10);
+  AddVars(m, n, 0.0, 10.0);
+  m.num_nl_vars = n;
+  int num_cons = std::max(1, scale / 20);
+  for (int i = 0; i < num_cons; ++i) {
+    NLExpr e;
+    e.Op(mp::expr::SUM).Count(4);
+    for (int k = 0; k < 4; ++k) {
+      e.Op(mp::expr::PLTERM).Count(5);
+      for (int b = 0; b < 4; ++b)
+        e.Num(rnd.Value(-5.0, 5.0)).Num(2.0 * (b + 1));
+      e.Num(rnd.Value(-5.0, 5.0)).Var(rnd.Index(n));
+    }
+    m.cons.push_back({-INFINITY, 20.0, rnd.Terms(n, 2), e});
+  }
+  m.obj_lin = rnd.Terms(n, std::min(n, 20));
+  return m;
+}
+
+/// Common expressions: scale/5 defined variables, each linear
+/// plus a product, and scale/5 constraints using 4 of them each
+SyntheticModel GenerateCommonExprs(int scale) {
+  SyntheticModel m;
+  m.name = "cexpr";
+  Random rnd(5);
+  int n = std::max(10, scale / 10);
+  AddVars(m, n, 0.0, 10.0);
+  m.num_nl_vars = n;
+  int num_cexprs = std::max(1, scale / 5);
+  for (int i = 0; i < num_cexprs; ++i) {
+    NLExpr e;
+    e.Op(mp::expr::MUL).Var(rnd.Index(n)).Var(rnd.Index(n));
+    m.cexprs.push_back({rnd.Terms(n, 2), e});
+  }
+  for (int i = 0; i < num_cexprs; ++i) {
+    NLExpr e;
+    e.Op(mp::expr::SUM).Count(4);
+    for (int k = 0; k < 4; ++k)
+      e.Var(n + rnd.Index(num_cexprs));
+    m.cons.push_back({-INFINITY, 100.0, rnd.Terms(n, 2), e});
+  }
+  m.obj_lin = rnd.Terms(n, std::min(n, 20));
+  return m;
+}
+
+
+/// Silent ModelAPI accepting the constraints of the visitor driver
+/// (linear, quadratic, indicator, SOS),
+/// plus quadratic objectives
+class BenchModelAPI : public mp::BasicFlatModelAPI {
+ public:
+  BenchModelAPI(mp::Env &) {}
+
+  static const char *GetTypeName() { return "BenchModelAPI"; }
+
+  void AddVariables(const mp::VarArrayDef &vad) { n_items_ += vad.size(); }
+  void SetLinearObjective(int , const mp::LinearObjective &) { ++n_items_; }
+  static int AcceptsQuadObj() { return 2; }
+  void SetQuadraticObjective(int , const mp::QuadraticObjective &)
+  { ++n_items_; }
+  static constexpr bool AcceptsNonconvexQC() { return true; }
+
+  using mp::BasicFlatModelAPI::AcceptanceLevel;
+  using mp::BasicFlatModelAPI::GroupNumber;
+  ACCEPT_CONSTRAINT(mp::LinConRange, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConLE, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConEQ, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::LinConGE, mp::Recommended, mp::CG_Linear)
+  ACCEPT_CONSTRAINT(mp::QuadConRange, mp::Recommended, mp::CG_Quadratic)
+  ACCEPT_CONSTRAINT(mp::QuadConLE, mp::Recommended, mp::CG_Quadratic)
+  ACCEPT_CONSTRAINT(mp::QuadConEQ, mp::Recommended, mp::CG_Quadratic)
+  ACCEPT_CONSTRAINT(mp::QuadConGE, mp::Recommended, mp::CG_Quadratic)
+  ACCEPT_CONSTRAINT(mp::IndicatorConstraintLinLE,
+                    mp::AcceptedButNotRecommended, mp::CG_General)
+  ACCEPT_CONSTRAINT(mp::IndicatorConstraintLinEQ,
+                    mp::AcceptedButNotRecommended, mp::CG_General)
+  ACCEPT_CONSTRAINT(mp::IndicatorConstraintLinGE,
+                    mp::AcceptedButNotRecommended, mp::CG_General)
+  ACCEPT_CONSTRAINT(mp::SOS1Constraint, mp::Recommended, mp::CG_SOS)
+  ACCEPT_CONSTRAINT(mp::SOS2Constraint, mp::Recommended, mp::CG_SOS)
+
+  template <class Constraint>
+  void AddConstraint(const Constraint &) { ++n_items_; }
+
+ private:
+  long n_items_ = 0;
+};
+
+using BenchFlattener = mp::ProblemFltImpl<mp::ProblemFlattener, mp::Problem,
+  mp::FlatCvtImpl<mp::MIPFlatConverter, BenchModelAPI> >;
+
+/// Env with the standard options
+class BenchEnv : public mp::Env {
+ public:
+  BenchEnv() : mp::Env("mp-bench", "mp-bench", 0, 0) {
+    // Collect run statistics, the file is not written
+    ParseOptionString("tech:timing:json=mp-bench.json", NO_OPTION_ECHO);
+  }
+};
+
+/// One run: read, convert, push to the ModelAPI, and postsolve.
+/// @return the run statistics
+mp::RunStats Run(const std::string &nl_file, const std::string &stub) {
+  BenchEnv env;
+  auto pflt = new BenchFlattener(env);
+  auto pmm = mp::CreateModelManagerWithStdBuilder(
+        std::unique_ptr< mp::BasicConverter<mp::Problem> >{ pflt });
+  pmm->InitOptions();
+  pmm->ReadNLModel(nl_file, stub, {});
+  auto &vp = pflt->GetFlatCvt().GetValuePresolver();
+  const auto &dest = vp.GetTargetNodes();
+  std::map<int, std::vector<double> > x, y;
+  for (const auto &vn: dest.GetVarValues().GetMap())
+    x[vn.first].assign(vn.second.Size(), 0.5);
+  for (const auto &cn: dest.GetConValues().GetMap())
+    y[cn.first].assign(cn.second.Size(), 1.0);
+  vp.PostsolveSolution({ mp::pre::ValueMapDbl(x), mp::pre::ValueMapDbl(y),
+                         mp::pre::ValueMapDbl(std::vector<double>{ 0.0 }) });
+  return *env.GetRunStats();
+}
+
+/// Benchmark results: name -> times of the repetitions
+class Results {
+ public:
+  void Add(const std::string &name, double t) { times_[name].push_back(t); }
+
+  void Print(const std::string &name, const std::string &counter = "") {
+    auto &t = times_[name];
+    std::sort(t.begin(), t.end());
+    fmt::print("{:<40} {:>12.3f} ms {:>12.3f} ms {:>6}   {}\n",
+               name, 1e3 * t[t.size() / 2], 1e3 * t.front(),
+               t.size(), counter);
+    stats_.Set("mp-bench", name, "median", t[t.size() / 2]);
+    stats_.Set("mp-bench", name, "min", t.front());
+  }
+
+  double Median(const std::string &name) const {
+    const auto &t = times_.at(name);
+    return t[t.size() / 2];
+  }
+
+  mp::RunStats &GetStats() { return stats_; }
+
+ private:
+  std::map<std::string, std::vector<double> > times_;
+  mp::RunStats stats_;
+};
+
+/// Benchmark one model in one NL format
+void Benchmark(const SyntheticModel &m, bool binary, int reps,
+               const std::string &dir, Results &res) {
+  std::string stub = dir + "/mp-bench-" + m.name + (binary ? "-b" : "");
+  std::string nl = m.WriteNL(binary);
+  if (!mp::WriteStringToFile(stub + ".nl", nl))
+    throw std::runtime_error("cannot write " + stub + ".nl");
+  std::string prefix = m.name + (binary ? "/binary" : "/text");
+  const char *phases[][3] = {
+    { "phases", "NL read", "ReadNLFile" },
+    { "phases", "ConvertStandardItems", "ConvertStandardItems" },
+    { "phases", "ConvertAllConstraints", "MIPRedefinitions" },
+    { "phases", "PushModelTo", "PushModelTo" },
+    { "postsolve", "Solution", "Postsolve" },
+  };
+  for (int r = 0; r < reps; ++r) {
+    auto rs = Run(stub + ".nl", stub);
+    for (const auto &ph: phases)
+      res.Add(ph[2] + ('/' + prefix), rs.Get(ph[0], ph[1], "time"));
+  }
+  std::remove((stub + ".nl").c_str());
+  double mb = nl.size() / 1e6;
+  for (std::size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); ++i) {
+    std::string name = phases[i][2] + ('/' + prefix);
+    res.Print(name, 0 == i ?
+                fmt::format("{:.1f} MB/s", mb / res.Median(name)) : "");
+  }
+}
+
+typedef SyntheticModel (*Generator)(int scale);
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int scale = 100000;
+  int reps = 5;
+  std::string models = "lp,qp,ite,pl,cexpr";
+  std::string dir = ".";
+  std::string json_file;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!std::strcmp(argv[i], "-s"))
+      scale = std::atoi(argv[i + 1]);
+    else if (!std::strcmp(argv[i], "-r"))
+      reps = std::max(1, std::atoi(argv[i + 1]));
+    else if (!std::strcmp(argv[i], "-m"))
+      models = argv[i + 1];
+    else if (!std::strcmp(argv[i], "-d"))
+      dir = argv[i + 1];
+    else if (!std::strcmp(argv[i], "-o"))
+      json_file = argv[i + 1];
+    else {
+      fmt::print(stderr, "Unknown argument: {}\n", argv[i]);
+      return 1;
+    }
+  }
+  const std::pair<const char*, Generator> generators[] = {
+    { "lp", GenerateLP }, { "qp", GenerateQP }, { "ite", GenerateITE },
+    { "pl", GeneratePL }, { "cexpr", GenerateCommonExprs },
+  };
+  Results res;
+  try {
+    fmt::print("Scale {}, {} repetitions\n", scale, reps);
+    fmt::print("{:<40} {:>15} {:>16} {:>6}\n",
+               "Benchmark", "Median", "Min", "Reps");
+    for (const auto &g: generators) {
+      if (("," + models + ",").find(std::string(",") + g.first + ",") ==
+          std::string::npos)
+        continue;
+      SyntheticModel m = g.second(scale);
+      fmt::print("--- {}: {} vars, {} algebraic cons, {} logical cons, "
+                 "{} common exprs\n",
+                 m.name, m.num_vars(), m.cons.size(),
+                 m.logical_cons.size(), m.cexprs.size());
+      Benchmark(m, false, reps, dir, res);
+      Benchmark(m, true, reps, dir, res);
+    }
+    if (json_file.size()) {
+      fmt::MemoryWriter w;
+      res.GetStats().WriteJSON(w);
+      if (!mp::WriteStringToFile(json_file, w.str()))
+        throw std::runtime_error("cannot write " + json_file);
+    }
+  } catch (const std::exception &e) {
+    fmt::print(stderr, "Error: {}\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,121 @@
+/*
+ Text .nl parsing throughput: "C" locale strtod vs FastLocale.
+
+ Copyright (C) 2023 AMPL Optimization Inc
+
+ Permission to use, copy, modify, and distribute this software and its
+ documentation for any purpose and without fee is hereby granted,
+ provided that the above copyright notice appear in all copies and that
+ both that the copyright notice and this permission notice and warranty
+ disclaimer appear in supporting documentation.
+
+ The author and AMPL Optimization Inc disclaim all warranties with
+ regard to this software, including all implied warranties of
+ merchantability and fitness.  In no event shall the author be liable
+ for any special, indirect or consequential damages or any damages
+ whatsoever resulting from loss of use, data or profits, whether in an
+ action of contract, negligence or other tortious action, arising out
+ of or in connection with the use or performance of this software.
+
+ Usage: nl-reader-speed-test [num_cons [nnz_per_con]]
+ */
+
+#include <cstdlib>
+#include <vector>
+
+#include "mp/clock.h"
+#include "mp/nl-reader.h"
+
+namespace {
+
+double RandomDouble() {
+  double d = (std::rand() - RAND_MAX / 2) / 1000.0;
+  switch (std::rand() % 3) {
+  case 0:
+    return d;
+  case 1:
+    return std::rand() % 100;
+  }
+  return d / 3;
+}
+
+// Generates a text .nl string of an LP with num_cons random rows.
+std::string GenerateLP(int num_cons, int nnz_per_con) {
+  int num_vars = num_cons;
+  std::vector<std::vector<int> > rows(num_cons);
+  std::vector<int> col_sizes(num_vars);
+  for (int i = 0; i < num_cons; ++i) {
+    for (int k = 0; k < nnz_per_con; ++k) {
+      int v = (i + k * (num_vars / nnz_per_con + 1)) % num_vars;
+      rows[i].push_back(v);
+      ++col_sizes[v];
+    }
+  }
+  mp::NLHeader h = mp::NLHeader();
+  h.num_vars = num_vars;
+  h.num_algebraic_cons = num_cons;
+  h.num_objs = 1;
+  h.num_con_nonzeros = num_cons * nnz_per_con;
+  h.num_obj_nonzeros = num_vars;
+  fmt::MemoryWriter w;
+  w << h;
+  for (int i = 0; i < num_cons; ++i)
+    w << 'C' << i << "\nn0\n";
+  w << "O0 0\nn0\n";
+  w << "x" << num_vars << '\n';
+  for (int j = 0; j < num_vars; ++j)
+    w.write("{} {:.17}\n", j, RandomDouble());
+  w << "r\n";
+  for (int i = 0; i < num_cons; ++i)
+    w.write("0 {:.17} {:.17}\n", -RandomDouble(), RandomDouble());
+  w << "b\n";
+  for (int j = 0; j < num_vars; ++j)
+    w.write("0 {} {:.17}\n", 0, RandomDouble());
+  w << 'k' << (num_vars - 1) << '\n';
+  int col_start = 0;
+  for (int j = 0; j + 1 < num_vars; ++j)
+    w << (col_start += col_sizes[j]) << '\n';
+  for (int i = 0; i < num_cons; ++i) {
+    w << 'J' << i << ' ' << nnz_per_con << '\n';
+    for (int k = 0; k < nnz_per_con; ++k)
+      w.write("{} {:.17}\n", rows[i][k], RandomDouble());
+  }
+  w << "G0 " << num_vars << '\n';
+  for (int j = 0; j < num_vars; ++j)
+    w.write("{} {}\n", j, RandomDouble());
+  return w.str();
+}
+
+template <typename Locale>
+double Parse(const std::string &nl, int flags = 0) {
+  typedef mp::internal::TextReader<Locale> Reader;
+  typedef mp::NullNLHandler<int> Handler;
+  mp::steady_clock::time_point start = mp::steady_clock::now();
+  Reader reader(mp::NLStringRef(nl.c_str(), nl.size()), "speed-test.nl");
+  mp::NLHeader header = mp::NLHeader();
+  reader.ReadHeader(header);
+  Handler handler;
+  mp::internal::NLReader<Reader, Handler>(
+        reader, header, handler, flags).Read();
+  return mp::GetTimeAndReset(start);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int num_cons = argc > 1 ? std::atoi(argv[1]) : 200000;
+  int nnz_per_con = argc > 2 ? std::atoi(argv[2]) : 10;
+  std::string nl = GenerateLP(num_cons, nnz_per_con);
+  double mb = nl.size() / 1e6;
+  fmt::print("Parsing {:.1f} MB of text NL ({} rows, {} nonzeros/row).\n",
+             mb, num_cons, nnz_per_con);
+  double strtod_time = Parse<mp::internal::Locale>(nl);
+  fmt::print("strtod:     {:.3f} s, {:.1f} MB/s\n",
+             strtod_time, mb / strtod_time);
+  double fast_time = Parse<mp::internal::FastLocale>(nl);
+  fmt::print("FastLocale: {:.3f} s, {:.1f} MB/s\n",
+             fast_time, mb / fast_time);
+  double parallel_time =
+      Parse<mp::internal::FastLocale>(nl, mp::READ_LINEAR_PARALLEL);
+  fmt::print("FastLocale, parallel G/J: {:.3f} s, {:.1f} MB/s\n",
+             parallel_time, mb / parallel_time);
+}
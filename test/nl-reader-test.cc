@@ -26,6 +26,8 @@
 #include "../src/nl-reader.cc"
 
 #include <climits>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
 
 #include "gmock/gmock.h"
@@ -148,6 +150,48 @@ TEST(TextReaderTest, ReadDouble) {
                    "test:1:13: expected double");
 }
 
+// Checks that ParseDouble either declines or agrees with strtod.
+void CheckParseDouble(const std::string &s) {
+  const char *str = s.c_str();
+  double value = 0;
+  if (!mp::internal::ParseDouble(str, value))
+    return;
+  char *end = 0;
+  double expected = std::strtod(s.c_str(), &end);
+  EXPECT_EQ(end, str) << s;
+  EXPECT_EQ(0, std::memcmp(&expected, &value, sizeof(value))) << s;
+}
+
+TEST(TextReaderTest, ParseDouble) {
+  const char *values[] = {
+    "0", "-0", "+0.0", "1", "-1", "4.2", ".5", "5.", "1e10", "1E-10",
+    "1e+308", "1.7976931348623157e308", "2.2250738585072014e-308",
+    "0.1", "0.30000000000000004", "123456789012345678", "9007199254740993",
+    "1.5e", "2e+", "3ex", "0.000000000000000000000000000001",
+    "1000000000000000000000", "1e400", "1e-400", "4.9e-324",
+    "inf", "nan", "0x10", "-", "."
+  };
+  for (std::size_t i = 0; i < sizeof(values) / sizeof(*values); ++i)
+    CheckParseDouble(values[i]);
+  const char *str = "0x1p3";
+  double value = 0;
+  EXPECT_FALSE(mp::internal::ParseDouble(str, value));
+  str = "4.25 ";
+  EXPECT_TRUE(mp::internal::ParseDouble(str, value));
+  EXPECT_EQ(4.25, value);
+  EXPECT_EQ(' ', *str);
+  // Random round-trip values and random digit strings.
+  std::srand(42);
+  for (int i = 0; i < 100000; ++i) {
+    int exp = std::rand() % 600 - 300;
+    double d = (std::rand() + 1.0) / RAND_MAX * std::pow(10.0, exp);
+    CheckParseDouble(fmt::format("{:.17}", d));
+    CheckParseDouble(fmt::format("{:.15}", d));
+    CheckParseDouble(fmt::format("{}e{}", std::rand() % 1000000000,
+                                 std::rand() % 700 - 350));
+  }
+}
+
 class MockLocale {
  public:
   MOCK_METHOD1(strtod, double (const char *&str));
@@ -1083,9 +1127,10 @@ TEST(NLReaderTest, NoNewlineAtEOF) {
       ReadError, "(input):11:2: expected newline");
 }
 
-std::string ReadNL(std::string body, bool var_bounds = true) {
+std::string ReadNL(std::string body, bool var_bounds = true, int flags = 0) {
   TestNLHandler handler;
-  ReadNLString(FormatHeader(MakeHeader(), var_bounds) + body, handler);
+  ReadNLString(FormatHeader(MakeHeader(), var_bounds) + body, handler,
+               "(input)", flags);
   return handler.log.str();
 }
 
@@ -1382,6 +1427,112 @@ TEST(NLReaderTest, ReadLinearConExpr) {
   EXPECT_READ_ERROR("J0 1\n5 0\n", "(input):18:1: integer 5 out of bounds");
 }
 
+TEST(NLReaderTest, ReadLinearExprsInParallel) {
+  std::string body = "G1 2\n1 1.3\n3 5\nJ0 2\n1 1.3\n3 5\n"
+      "J5 4\n1 1\n2 1\n3 1\n4 1\nC0\nn4.2\nJ1 1\n0 -2.5\n";
+  for (int i = 0; i < 20000; ++i)
+    body += fmt::format("J{} 3\n0 {}\n2 0.{}\n4 {}e-3\n", i % 7, i, i, i);
+  EXPECT_EQ(ReadNL(body), ReadNL(body, true, mp::READ_LINEAR_PARALLEL));
+  EXPECT_EQ(ReadNL(body, true, mp::READ_BOUNDS_FIRST),
+            ReadNL(body, true,
+                   mp::READ_BOUNDS_FIRST | mp::READ_LINEAR_PARALLEL));
+  EXPECT_THROW_MSG(ReadNL(body + "J0 1\n5 0\n", true,
+                          mp::READ_LINEAR_PARALLEL),
+                   ReadError, "(input):80033:1: integer 5 out of bounds");
+  EXPECT_THROW_MSG(ReadNL("G0 1\n-1 0\n", true, mp::READ_LINEAR_PARALLEL),
+                   ReadError, "(input):18:1: expected unsigned integer");
+  EXPECT_THROW_MSG(ReadNL("J0 2\n1 0\n", true, mp::READ_LINEAR_PARALLEL),
+                   ReadError, "(input):19:1: expected newline");
+}
+
+TEST(NLReaderTest, ReadBinaryLinearExprsInParallel) {
+  NLHeader header = MakeHeader();
+  header.format = NLHeader::BINARY;
+  header.arith_kind = mp::arith::GetKind();
+  std::string nl = FormatHeader(header, false) + "b33333";
+  for (int i = 0; i < 1000; ++i) {
+    int seg[] = {i % 7, 2, 1, 0, 0, 3, 0, 0};
+    double coefs[] = {i * 0.1, 5.0 / (i + 1)};
+    std::memcpy(seg + 3, coefs, sizeof(double));
+    std::memcpy(seg + 6, coefs + 1, sizeof(double));
+    nl += 'J';
+    nl.append(reinterpret_cast<const char*>(seg), sizeof(seg));
+  }
+  TestNLHandler handler, parallel_handler;
+  ReadNLString(nl, handler);
+  ReadNLString(nl, parallel_handler, "(input)", mp::READ_LINEAR_PARALLEL);
+  EXPECT_EQ(handler.log.str(), parallel_handler.log.str());
+  EXPECT_THROW_MSG(ReadNLString(nl.substr(0, nl.size() - 1), handler,
+                                "test", mp::READ_LINEAR_PARALLEL),
+                   mp::BinaryReadError,
+                   fmt::format("test:offset {}: unexpected end of file",
+                               nl.size() - 1));
+}
+
+// Receives linear constraint expressions in blocks.
+class LinearConBlockHandler : public TestNLHandler {
+ public:
+  std::string blocks;
+
+  void OnLinearConBlock(int first_con, int num_cons, const int *starts,
+                        const int *vars, const double *coefs) {
+    blocks += fmt::format("[{}, {}) ", first_con, first_con + num_cons);
+    EXPECT_EQ(0, starts[0]);
+    for (int i = 0; i < num_cons; ++i) {
+      LinearConHandler con = OnLinearConExpr(
+            first_con + i, starts[i + 1] - starts[i]);
+      for (int k = starts[i]; k < starts[i + 1]; ++k)
+        con.AddTerm(vars[k], coefs[k]);
+    }
+  }
+};
+
+TEST(NLReaderTest, HasLinearConBlock) {
+  EXPECT_FALSE(mp::internal::HasLinearConBlock<TestNLHandler>::value);
+  EXPECT_TRUE(mp::internal::HasLinearConBlock<LinearConBlockHandler>::value);
+  EXPECT_TRUE(mp::internal::HasLinearConBlock<
+                mp::internal::NLProblemBuilder<mp::Problem> >::value);
+}
+
+TEST(NLReaderTest, ReadLinearConBlocks) {
+  std::string body = "J0 2\n1 1.3\n3 5\nJ1 1\n0 -2.5\nJ2 1\n4 1\n"
+      "G1 2\n1 1.3\n3 5\nJ3 1\n2 7\nC0\nn4.2\nJ5 4\n1 1\n2 1\n3 1\n4 1\n"
+      "J4 1\n0 1\nJ6 1\n1 0.5\n";
+  std::string nl = FormatHeader(MakeHeader(), true) + body;
+  TestNLHandler handler;
+  ReadNLString(nl, handler);
+  int flags[] = {0, mp::READ_LINEAR_PARALLEL};
+  for (std::size_t i = 0; i < sizeof(flags) / sizeof(*flags); ++i) {
+    LinearConBlockHandler block_handler;
+    ReadNLString(nl, block_handler, "(input)", flags[i]);
+    EXPECT_EQ(handler.log.str(), block_handler.log.str());
+    EXPECT_EQ("[0, 3) [3, 4) [5, 6) [4, 5) [6, 7) ", block_handler.blocks);
+  }
+  LinearConBlockHandler block_handler;
+  EXPECT_THROW_MSG(ReadNLString(nl + "J0 1\n5 0\n", block_handler),
+                   ReadError, "(input):41:1: integer 5 out of bounds");
+  EXPECT_EQ("[0, 3) [3, 4) ", block_handler.blocks);
+}
+
+TEST(NLReaderTest, ReadLinearConBlocksIntoProblem) {
+  std::string nl = FormatHeader(MakeHeader(), true) +
+      "J1 1\n0 -2.5\nJ0 2\n1 1.3\n3 5\nJ2 1\n4 1\n";
+  mp::Problem p;
+  ReadNLString(nl, p);
+  mp::LinearExpr e = p.algebraic_con(0).linear_expr();
+  EXPECT_TRUE(e.is_view());
+  ASSERT_EQ(2, e.num_terms());
+  EXPECT_EQ(1, e.var_index(0));
+  EXPECT_EQ(1.3, e.coef(0));
+  EXPECT_EQ(3, e.var_index(1));
+  EXPECT_EQ(5, e.coef(1));
+  e = p.algebraic_con(1).linear_expr();
+  ASSERT_EQ(1, e.num_terms());
+  EXPECT_EQ(0, e.var_index(0));
+  EXPECT_EQ(-2.5, e.coef(0));
+  EXPECT_EQ(1, p.algebraic_con(2).linear_expr().num_terms());
+}
+
 TEST(NLReaderTest, ReadColumnSizes) {
   EXPECT_READ("sizes: 1 2 2 4;", "k4\n1\n3\n5\n9\n");
   EXPECT_READ("sizes: 1 2 2 4;", "K4\n1\n2\n2\n4\n");
@@ -1479,6 +1630,26 @@ TEST(NLReaderTest, ReadNLFileMultipleOfPageSize) {
   CheckReadFile(nl + "\n");
 }
 
+TEST(NLReaderTest, ReadNLFileMode) {
+  std::string nl = FormatHeader(MakeHeader()) + "C0\nn4.2\n";
+  const char *filename = "test.nl";
+  WriteFile(filename, nl);
+  typedef mp::internal::NLFileReader<> Reader;
+  Reader reader;
+  EXPECT_EQ(Reader::READ_MMAP, reader.mode());
+  TestNLHandler handler;
+  reader.Read(filename, handler, 0);
+  EXPECT_TRUE(reader.mapped());
+  EXPECT_EQ("v0 <= 0; v1 <= 0; v2 <= 0; v3 <= 0; v4 <= 0; c0: 4.2;",
+            handler.log.str());
+  reader.set_mode(Reader::READ_COPY);
+  TestNLHandler copy_handler;
+  reader.Read(filename, copy_handler, 0);
+  EXPECT_FALSE(reader.mapped());
+  EXPECT_GE(reader.load_time(), 0);
+  EXPECT_EQ(handler.log.str(), copy_handler.log.str());
+}
+
 struct Cancel {};
 
 TEST(NLReaderTest, FileTooBig) {
@@ -1879,6 +2050,19 @@ TEST_F(NLProblemBuilderTest, OnLinearConExpr) {
   EXPECT_EQ(con_builder, adapter.OnLinearConExpr(42, 11));
 }
 
+TEST_F(NLProblemBuilderTest, OnLinearConBlock) {
+  MockProblemBuilder::AlgebraicCon con1, con2;
+  EXPECT_CALL(builder, algebraic_con(3)).WillOnce(ReturnRef(con1));
+  EXPECT_CALL(builder, algebraic_con(4)).WillOnce(ReturnRef(con2));
+  auto con_builder1 = TestLinearConBuilder(ID), con_builder2 =
+      TestLinearConBuilder();
+  EXPECT_CALL(con1, set_linear_expr(2)).WillOnce(Return(con_builder1));
+  EXPECT_CALL(con2, set_linear_expr(1)).WillOnce(Return(con_builder2));
+  int starts[] = {0, 2, 3}, vars[] = {1, 0, 2};
+  double coefs[] = {1.5, 2, 3};
+  adapter.OnLinearConBlock(3, 2, starts, vars, coefs);
+}
+
 TEST_F(NLProblemBuilderTest, OnConBounds) {
   MockProblemBuilder::AlgebraicCon con;
   EXPECT_CALL(builder, algebraic_con(42)).WillOnce(ReturnRef(con));
@@ -95,6 +95,31 @@ TEST(ProblemTest, LinearExprIterator) {
   EXPECT_EQ(++i, e.end());
 }
 
+TEST(ProblemTest, LinearExprView) {
+  int vars[] = {3, 1, 4};
+  double coefs[] = {1.5, 9, 2.6};
+  mp::LinearExpr e = mp::LinearExpr::View(vars, coefs, 3);
+  EXPECT_TRUE(e.is_view());
+  EXPECT_LINEAR_EXPR(e, vars, coefs);
+  EXPECT_EQ(vars, e.vars());
+  mp::LinearExpr copy = e;
+  EXPECT_TRUE(copy.is_view());
+  EXPECT_EQ(coefs, copy.coefs());
+  // Modification copies the terms.
+  copy.set_coef(1, 5);
+  EXPECT_FALSE(copy.is_view());
+  EXPECT_EQ(5, copy.coef(1));
+  EXPECT_EQ(9, coefs[1]);
+  e.AddTerm(7, 1);
+  EXPECT_FALSE(e.is_view());
+  int vars2[] = {3, 1, 4, 7};
+  double coefs2[] = {1.5, 9, 2.6, 1};
+  EXPECT_LINEAR_EXPR(e, vars2, coefs2);
+  mp::LinearExpr owned_copy = e;
+  EXPECT_NE(e.vars(), owned_copy.vars());
+  EXPECT_LINEAR_EXPR(owned_copy, vars2, coefs2);
+}
+
 TEST(ProblemTest, AddVar) {
   Problem p;
   EXPECT_EQ(0, p.num_vars());
@@ -495,6 +520,37 @@ TEST(ProblemTest, LogicalCons) {
   EXPECT_ASSERT(*i, "invalid access");
 }
 
+TEST(ProblemTest, SetLinearConExprs) {
+  Problem p;
+  p.AddVars(5, 0, 1);
+  for (int i = 0; i < 4; ++i)
+    p.AddCon(0, 1);
+  p.algebraic_con(2).linear_expr().AddTerm(0, 42);
+  int starts[] = {0, 2, 2, 3}, vars[] = {4, 1, 3};
+  double coefs[] = {1.5, -2, 7};
+  p.SetLinearConExprs(1, 3, starts, vars, coefs);
+  EXPECT_EQ(0, p.algebraic_con(0).linear_expr().num_terms());
+  const mp::LinearExpr &e1 = p.algebraic_con(1).linear_expr();
+  EXPECT_TRUE(e1.is_view());
+  int vars1[] = {4, 1};
+  double coefs1[] = {1.5, -2};
+  EXPECT_LINEAR_EXPR(e1, vars1, coefs1);
+  // Terms are appended to existing ones.
+  int vars2[] = {0};
+  double coefs2[] = {42};
+  EXPECT_LINEAR_EXPR(p.algebraic_con(2).linear_expr(), vars2, coefs2);
+  int vars3[] = {3};
+  double coefs3[] = {7};
+  EXPECT_LINEAR_EXPR(p.algebraic_con(3).linear_expr(), vars3, coefs3);
+  // The mutable API still works on views.
+  p.algebraic_con(1).set_linear_expr(3).AddTerm(2, 1);
+  int vars4[] = {4, 1, 2};
+  double coefs4[] = {1.5, -2, 1};
+  EXPECT_LINEAR_EXPR(p.algebraic_con(1).linear_expr(), vars4, coefs4);
+  EXPECT_ASSERT(p.SetLinearConExprs(2, 3, starts, vars, coefs),
+                "invalid index");
+}
+
 TEST(ProblemTest, HasNonlinearCons) {
   Problem p;
   p.AddVar(0, 1);
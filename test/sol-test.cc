@@ -0,0 +1,247 @@
+/*
+ .sol writer tests
+
+ Copyright (C) 2026 AMPL Optimization Inc
+
+ Permission to use, copy, modify, and distribute this software and its
+ documentation for any purpose and without fee is hereby granted,
+ provided that the above copyright notice appear in all copies and that
+ both that the copyright notice and this permission notice and warranty
+ disclaimer appear in supporting documentation.
+
+ The author and AMPL Optimization Inc disclaim all warranties with
+ regard to this software, including all implied warranties of
+ merchantability and fitness.  In no event shall the author be liable
+ for any special, indirect or consequential damages or any damages
+ whatsoever resulting from loss of use, data or profits, whether in an
+ action of contract, negligence or other tortious action, arising out
+ of or in connection with the use or performance of this software.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "mp/sol.h"
+#include "mp/suffix.h"
+
+namespace suf = mp::suf;
+
+namespace {
+
+// A solution for WriteSolFile / WriteBinarySolFile.
+struct TestSolution {
+  std::vector<int> options;
+  std::vector<double> values, dual_values;
+  mp::SuffixSet var_suffixes, con_suffixes, obj_suffixes, problem_suffixes;
+
+  int status() const { return 103; }
+  const char *message() const { return "test solver: optimal\n3 iterations"; }
+
+  int num_options() const { return static_cast<int>(options.size()); }
+  int option(int index) const { return options[index]; }
+
+  int num_values() const { return static_cast<int>(values.size()); }
+  double value(int index) const { return values[index]; }
+
+  int num_dual_values() const { return static_cast<int>(dual_values.size()); }
+  double dual_value(int index) const { return dual_values[index]; }
+
+  int objno() const { return 1; }
+  int num_vars() const { return num_values(); }
+  int num_algebraic_cons() const { return num_dual_values(); }
+
+  const mp::SuffixSet *suffixes(suf::Kind kind) const {
+    switch (kind) {
+    case suf::VAR: return &var_suffixes;
+    case suf::CON: return &con_suffixes;
+    case suf::OBJ: return &obj_suffixes;
+    default: return &problem_suffixes;
+    }
+  }
+};
+
+// A suffix as read back from a .sol file.
+struct SolSuffix {
+  std::vector<int> header;
+  std::string name, table;
+  std::vector<std::pair<int, double> > values;
+};
+
+// Contents of a .sol file.
+struct SolContents {
+  std::vector<std::string> message;
+  std::vector<int> options;
+  std::vector<int> sizes;           // ncons, nduals, nvars, nvalues
+  std::vector<double> dual_values, values;
+  int objno = 0, status = 0;
+  std::vector<SolSuffix> suffixes;
+};
+
+SolContents ReadTextSol(const char *filename) {
+  SolContents sol;
+  std::ifstream f(filename);
+  std::string line;
+  while (std::getline(f, line) && !line.empty())
+    sol.message.push_back(line);
+  std::getline(f, line);
+  EXPECT_EQ("Options", line);
+  int nopts = 0;
+  f >> nopts;
+  sol.options.resize(nopts);
+  for (auto &o: sol.options)
+    f >> o;
+  sol.sizes.resize(4);
+  for (auto &s: sol.sizes)
+    f >> s;
+  sol.dual_values.resize(sol.sizes[1]);
+  for (auto &d: sol.dual_values)
+    f >> d;
+  sol.values.resize(sol.sizes[3]);
+  for (auto &v: sol.values)
+    f >> v;
+  f >> line >> sol.objno >> sol.status;
+  EXPECT_EQ("objno", line);
+  while (f >> line) {
+    EXPECT_EQ("suffix", line);
+    SolSuffix s;
+    s.header.resize(5);
+    for (auto &h: s.header)
+      f >> h;
+    f >> s.name;
+    if (s.header[3]) {
+      std::getline(f, line);
+      for (int i = 0; i < s.header[4]; ++i) {
+        std::getline(f, line);
+        s.table += (i ? "\n" : "") + line;
+      }
+    }
+    s.values.resize(s.header[1]);
+    for (auto &v: s.values)
+      f >> v.first >> v.second;
+    sol.suffixes.push_back(s);
+  }
+  return sol;
+}
+
+// Reads a binary .sol record, checking the size at both ends.
+std::string ReadRecord(std::FILE *f) {
+  int size = -1, size2 = -2;
+  EXPECT_EQ(1u, std::fread(&size, sizeof(size), 1, f));
+  std::string data(size, ' ');
+  if (size) {
+    EXPECT_EQ(1u, std::fread(&data[0], size, 1, f));
+  }
+  EXPECT_EQ(1u, std::fread(&size2, sizeof(size2), 1, f));
+  EXPECT_EQ(size, size2);
+  return data;
+}
+
+template <typename T>
+std::vector<T> ToVector(const std::string &data) {
+  std::vector<T> result(data.size() / sizeof(T));
+  if (!result.empty())
+    std::memcpy(result.data(), data.data(), data.size());
+  return result;
+}
+
+SolContents ReadBinarySol(const char *filename) {
+  SolContents sol;
+  std::FILE *f = std::fopen(filename, "rb");
+  EXPECT_EQ("binary", ReadRecord(f));
+  for (std::string line; !(line = ReadRecord(f)).empty(); )
+    sol.message.push_back(line);
+  auto header = ToVector<int>(ReadRecord(f));
+  sol.options.assign(header.begin() + 1, header.begin() + 1 + header[0]);
+  sol.sizes.assign(header.begin() + 1 + header[0], header.end());
+  if (sol.sizes[1])
+    sol.dual_values = ToVector<double>(ReadRecord(f));
+  if (sol.sizes[3])
+    sol.values = ToVector<double>(ReadRecord(f));
+  auto objno = ToVector<int>(ReadRecord(f));
+  sol.objno = objno[0];
+  sol.status = objno[1];
+  for (int c; (c = std::fgetc(f)) != EOF; ) {
+    std::ungetc(c, f);
+    SolSuffix s;
+    s.header = ToVector<int>(ReadRecord(f));
+    s.name = ReadRecord(f);
+    s.name.resize(s.header[2] - 1);          // drop the terminating 0
+    if (s.header[3]) {
+      s.table = ReadRecord(f);
+      s.table.resize(s.header[3] - 1);
+    }
+    std::string data = ReadRecord(f);
+    bool is_float = (s.header[0] & suf::FLOAT) != 0;
+    std::size_t pair_size = sizeof(int) + (is_float ? sizeof(double) : sizeof(int));
+    for (std::size_t pos = 0; pos < data.size(); pos += pair_size) {
+      int index = 0, ival = 0;
+      double dval = 0;
+      std::memcpy(&index, &data[pos], sizeof(int));
+      if (is_float)
+        std::memcpy(&dval, &data[pos + sizeof(int)], sizeof(double));
+      else
+        std::memcpy(&ival, &data[pos + sizeof(int)], sizeof(int));
+      s.values.push_back(std::make_pair(index, is_float ? dval : ival));
+    }
+    sol.suffixes.push_back(s);
+  }
+  std::fclose(f);
+  return sol;
+}
+
+TEST(SolTest, BinaryRoundTripMatchesText) {
+  TestSolution sol;
+  sol.options = {3, 1, 1, 0};
+  sol.values = {1.5, -2.25, 0, 1e-300, 12345678.875};
+  sol.dual_values = {0.125, -7};
+  auto sstatus = sol.var_suffixes.Add<int>(
+        "sstatus", suf::VAR | suf::OUTPUT, 5, "0 none\n1 bas\n2 sup");
+  sstatus.set_value(0, 1);
+  sstatus.set_value(3, 2);
+  auto dunbdd = sol.con_suffixes.Add<double>(
+        "dunbdd", suf::CON | suf::OUTPUT, 2);
+  dunbdd.set_value(1, -0.5);
+  sol.con_suffixes.Add<int>("input_only", suf::CON, 2).set_value(0, 1);
+  sol.problem_suffixes.Add<int>(
+        "nsol", suf::PROBLEM | suf::OUTPUT, 1).set_value(0, 4);
+
+  mp::WriteSolFile("test-text.sol", sol);
+  mp::WriteBinarySolFile("test-binary.sol", sol);
+  SolContents text = ReadTextSol("test-text.sol");
+  SolContents binary = ReadBinarySol("test-binary.sol");
+
+  EXPECT_EQ(text.message, binary.message);
+  EXPECT_EQ(sol.options, binary.options);
+  EXPECT_EQ(text.options, binary.options);
+  EXPECT_EQ(std::vector<int>({2, 2, 5, 5}), binary.sizes);
+  EXPECT_EQ(text.sizes, binary.sizes);
+  EXPECT_EQ(sol.values, binary.values);        // exact
+  EXPECT_EQ(sol.dual_values, binary.dual_values);
+  ASSERT_EQ(text.values.size(), binary.values.size());
+  for (std::size_t i = 0; i < text.values.size(); ++i)
+    EXPECT_DOUBLE_EQ(text.values[i], binary.values[i]);
+  EXPECT_EQ(0, binary.objno);
+  EXPECT_EQ(103, binary.status);
+  EXPECT_EQ(text.objno, binary.objno);
+  EXPECT_EQ(text.status, binary.status);
+  ASSERT_EQ(3u, binary.suffixes.size());
+  ASSERT_EQ(text.suffixes.size(), binary.suffixes.size());
+  for (std::size_t i = 0; i < text.suffixes.size(); ++i) {
+    EXPECT_EQ(text.suffixes[i].header, binary.suffixes[i].header);
+    EXPECT_EQ(text.suffixes[i].name, binary.suffixes[i].name);
+    EXPECT_EQ(text.suffixes[i].table, binary.suffixes[i].table);
+    EXPECT_EQ(text.suffixes[i].values, binary.suffixes[i].values);
+  }
+  EXPECT_EQ("sstatus", binary.suffixes[0].name);
+  EXPECT_EQ("0 none\n1 bas\n2 sup", binary.suffixes[0].table);
+  EXPECT_EQ((std::vector<std::pair<int, double> >{{0, 1}, {3, 2}}),
+            binary.suffixes[0].values);
+  std::remove("test-text.sol");
+  std::remove("test-binary.sol");
+}
+
+}  // namespace
@@ -0,0 +1,124 @@
+/*
+ Canonicalization of linear and quadratic terms:
+ LinTerms/QuadTerms::sort_terms() vs the former std::map-based version.
+
+ Copyright (C) 2023 AMPL Optimization Inc
+
+ Permission to use, copy, modify, and distribute this software and its
+ documentation for any purpose and without fee is hereby granted,
+ provided that the above copyright notice appear in all copies and that
+ both that the copyright notice and this permission notice and warranty
+ disclaimer appear in supporting documentation.
+
+ The author and AMPL Optimization Inc disclaim all warranties with
+ regard to this software, including all implied warranties of
+ merchantability and fitness.  In no event shall the author be liable
+ for any special, indirect or consequential damages or any damages
+ whatsoever resulting from loss of use, data or profits, whether in an
+ action of contract, negligence or other tortious action, arising out
+ of or in connection with the use or performance of this software.
+
+ Usage: sort-terms-speed-test [total_terms]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "mp/clock.h"
+#include "mp/format.h"
+#include "mp/flat/expr_quadratic.h"
+
+namespace {
+
+// The map-based canonicalization sort_terms() used to do.
+void MapSortTerms(mp::LinTerms &lt) {
+  std::map<int, double> var_coef_map;
+  for (std::size_t i = 0; i < lt.size(); ++i)
+    if (0.0 != std::fabs(lt.coef(i)))
+      var_coef_map[lt.var(i)] += lt.coef(i);
+  mp::LinTerms result;
+  for (const auto &vc: var_coef_map)
+    if (0.0 != std::fabs(vc.second))
+      result.add_term(vc.second, vc.first);
+  lt = std::move(result);
+}
+
+void MapSortTerms(mp::QuadTerms &qt) {
+  std::map<std::pair<int, int>, double> var_coef_map;
+  for (int i = 0; i < (int)qt.size(); ++i) {
+    if (0.0 != std::fabs(qt.coef(i))) {
+      int v1 = qt.var1(i), v2 = qt.var2(i);
+      var_coef_map[v1 < v2 ? std::make_pair(v1, v2) : std::make_pair(v2, v1)]
+          += qt.coef(i);
+    }
+  }
+  mp::QuadTerms result;
+  for (const auto &vc: var_coef_map)
+    if (0.0 != std::fabs(vc.second))
+      result.add_term(vc.second, vc.first.first, vc.first.second);
+  qt = std::move(result);
+}
+
+// Random terms over num_terms/2 variables, i.e. with duplicates.
+std::vector<mp::LinTerms> MakeLinTerms(
+    int num_terms, int num_exprs, std::mt19937 &rng) {
+  std::uniform_int_distribution<int> var(0, num_terms / 2);
+  std::uniform_int_distribution<int> coef(-5, 5);
+  std::vector<mp::LinTerms> exprs(num_exprs);
+  for (auto &lt: exprs)
+    for (int i = 0; i < num_terms; ++i)
+      lt.add_term(coef(rng), var(rng));
+  return exprs;
+}
+
+std::vector<mp::QuadTerms> MakeQuadTerms(
+    int num_terms, int num_exprs, std::mt19937 &rng) {
+  std::uniform_int_distribution<int> var(
+      0, static_cast<int>(std::sqrt(num_terms)));
+  std::uniform_int_distribution<int> coef(-5, 5);
+  std::vector<mp::QuadTerms> exprs(num_exprs);
+  for (auto &qt: exprs)
+    for (int i = 0; i < num_terms; ++i)
+      qt.add_term(coef(rng), var(rng), var(rng));
+  return exprs;
+}
+
+// Canonicalizes copies of the expressions with both versions
+// and reports the times.
+template <typename Terms>
+bool Report(const char *name, int num_terms,
+            const std::vector<Terms> &exprs) {
+  std::vector<Terms> by_map = exprs, by_sort = exprs;
+  mp::steady_clock::time_point start = mp::steady_clock::now();
+  for (auto &t: by_map)
+    MapSortTerms(t);
+  double map_time = mp::GetTimeAndReset(start);
+  for (auto &t: by_sort)
+    t.sort_terms();
+  double sort_time = mp::GetTimeAndReset(start);
+  bool same = by_map == by_sort;
+  fmt::print("{:<10} {:>7} terms x {:>6}: map {:.3f} s, sort {:.3f} s{}\n",
+             name, num_terms, exprs.size(), map_time, sort_time,
+             same ? "" : "  RESULTS DIFFER");
+  return same;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  int total_terms = argc > 1 ? std::atoi(argv[1]) : 2000000;
+  std::mt19937 rng(42);
+  bool ok = true;
+  for (int num_terms: {10, 1000, 100000}) {
+    int num_exprs = std::max(1, total_terms / num_terms);
+    ok = Report("LinTerms", num_terms,
+                MakeLinTerms(num_terms, num_exprs, rng)) && ok;
+    ok = Report("QuadTerms", num_terms,
+                MakeQuadTerms(num_terms, num_exprs, rng)) && ok;
+  }
+  return ok ? 0 : 1;
+}
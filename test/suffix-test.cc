@@ -248,6 +248,57 @@ TEST_F(SuffixTest, ValuesZeroInitialized) {
   EXPECT_EQ(0, s.value(0));
 }
 
+TEST_F(SuffixTest, SparseSuffixValues) {
+  auto s = suffixes_.AddForNonzeros<int>("test", 0, 100, 3);
+  EXPECT_TRUE(s.is_sparse());
+  EXPECT_EQ(100, s.num_values());
+  s.set_value(70, 7);
+  s.set_value(5, 0);
+  s.set_value(10, 1);
+  s.set_value(90, 9);
+  s.set_value(10, 2);
+  EXPECT_EQ(2, s.value(10));
+  EXPECT_EQ(7, s.value(70));
+  EXPECT_EQ(0, s.value(5));
+  EXPECT_EQ(0, s.value(99));
+  EXPECT_ASSERT(s.value(100), "index out of bounds");
+  MockValueVisitor v;
+  testing::InSequence seq;
+  EXPECT_CALL(v, Visit(10, Matcher<int>(2)));
+  EXPECT_CALL(v, Visit(70, Matcher<int>(7)));
+  EXPECT_CALL(v, Visit(90, Matcher<int>(9)));
+  s.VisitValues(v);
+  auto values = s.get_values();
+  ASSERT_EQ(100u, values.size());
+  EXPECT_EQ(7, values[70]);
+  EXPECT_EQ(0, values[71]);
+}
+
+TEST_F(SuffixTest, DenseIfManyNonzeros) {
+  EXPECT_FALSE(suffixes_.AddForNonzeros<double>("a", 0, 100, 50).is_sparse());
+  EXPECT_FALSE(suffixes_.AddForNonzeros<double>("b", 0, 100, -1).is_sparse());
+  EXPECT_TRUE(suffixes_.AddForNonzeros<double>("c", 0, 100, 25).is_sparse());
+}
+
+TEST_F(SuffixTest, SwitchSparseDense) {
+  auto s = suffixes_.Add<double>("test", 0, 5);
+  s.set_value(1, 1.5);
+  s.set_value(4, -2);
+  suffixes_.SetSparse(s, true);
+  EXPECT_TRUE(s.is_sparse());
+  EXPECT_EQ(1.5, s.value(1));
+  EXPECT_EQ(-2, s.value(4));
+  EXPECT_EQ(0, s.value(0));
+  double values[] = {0, 0, 3, 0, 0};
+  s.set_values(values);
+  EXPECT_EQ(0, s.value(1));
+  EXPECT_EQ(3, s.value(2));
+  suffixes_.SetSparse(s, false);
+  EXPECT_FALSE(s.is_sparse());
+  EXPECT_EQ(3, s.get_values()[2]);
+  EXPECT_EQ(0, s.get_values()[4]);
+}
+
 TEST(SuffixSetTest, Empty) {
   mp::SuffixSet s;
   EXPECT_EQ(s.begin(), s.end());